@@ -1,76 +1,139 @@
 #include "Benchmark.h"
 #include "../solve/FVFSolver.h"
+#include "../solve/FrontierJonesSolver.h"
 #include "../solve/JonesSolver.h"
 #include "../solve/LDFSolver.h"
 #include "../solve/LubySolver.h"
 #include "../solve/RandomSelectionSolver.h"
 #include "../solve/SDLSolver.h"
 #include "../solve/SequentialSolver.h"
+#include "../solve/WarmStartSolver.h"
+#include "../graph/ColoringStats.h"
+#include "../utils/PageAllocator.h"
 #include "MemoryMonitor.h"
 #include <chrono>
+#include <cinttypes>
 #include <iostream>
+#include <thread>
 
-Benchmark::Benchmark(Graph &g) : solvers({
-                                     new SequentialSolver(),
+std::vector<Solver *> Benchmark::default_solvers() {
+    return {
+        new SequentialSolver(),
 
-                                     new LubySolver(1),
-                                     new LubySolver(2),
-                                     new LubySolver(4),
+        new LubySolver(1),
+        new LubySolver(2),
+        new LubySolver(4),
 
-                                     new JonesSolver(1),
-                                     new JonesSolver(2),
-                                     new JonesSolver(4),
+        new JonesSolver(1),
+        new JonesSolver(2),
+        new JonesSolver(4),
 
-                                     new SDLSolver(1),
-                                     new SDLSolver(2),
-                                     new SDLSolver(4),
+        new FrontierJonesSolver(1),
+        new FrontierJonesSolver(2),
+        new FrontierJonesSolver(4),
 
-                                     new LDFSolver(1),
-                                     new LDFSolver(2),
-                                     new LDFSolver(4),
+        new SDLSolver(1),
+        new SDLSolver(2),
+        new SDLSolver(4),
 
-                                     new FVFSolver(1),
-                                     new FVFSolver(2),
-                                     new FVFSolver(4),
+        new LDFSolver(1),
+        new LDFSolver(2),
+        new LDFSolver(4),
 
-                                     new RandomSelectionSolver(1),
-                                     new RandomSelectionSolver(2),
-                                     new RandomSelectionSolver(4),
-                                 }),
-                                 graph(g) {}
+        new FVFSolver(1),
+        new FVFSolver(2),
+        new FVFSolver(4),
+
+        new RandomSelectionSolver(1),
+        new RandomSelectionSolver(2),
+        new RandomSelectionSolver(4),
+    };
+}
+
+Benchmark::Benchmark(const Graph &g) : solvers(default_solvers()), graph(&g) {}
+
+Benchmark::Benchmark(const CompressedGraph &g) : solvers(default_solvers()), compressed(&g) {
+    std::erase_if(solvers, [](Solver *s) {
+        if (s->supports_compressed())
+            return false;
+        delete s;
+        return true;
+    });
+}
+
+std::pair<std::string, std::string> Benchmark::round_columns(const Solver *solver) {
+    std::vector<uint64_t> sizes = solver->round_sizes();
+    if (sizes.empty())
+        return {"", ""};
+    std::string joined;
+    for (uint64_t size : sizes)
+        joined += (joined.empty() ? "" : " ") + std::to_string(size);
+    return {std::to_string(sizes.size()), joined};
+}
 
 void Benchmark::run() {
+    if (settings.warm_start) {
+        for (Solver *s : solvers)
+            delete s;
+        solvers = {
+            new WarmStartSolver(*settings.warm_start, 1),
+            new WarmStartSolver(*settings.warm_start, 2),
+            new WarmStartSolver(*settings.warm_start, 4),
+        };
+    }
+
     // CSV header
     if (settings.output == settings.USE_CSV)
-        printf("Graph,Vertices,Edges,Solver,Time elapsed,Memory usage,Success,Colors\n");
+        printf("Graph,Vertices,Edges,Solver,Time elapsed,Memory usage,Success,Colors,Ordering,Page size,Rounds,Round sizes\n");
+    // Pages backing the graph, which determine the TLB reach of the solvers (see AllocationPolicy)
+    std::string page_size = AllocationPolicy::global().page_size();
+    if (settings.output == settings.USE_TEXT)
+        std::cout << "Page size: " << page_size << std::endl
+                  << std::endl;
 
     for (Solver *s : solvers) {
         if (settings.output == settings.USE_TEXT) {
             std::cout << s->name() << ":" << std::endl;
             struct result res = run_single(s);
-            printf("%.2f ms, %.2f MB (%s, %d colors)\n\n",
+            printf("%.2f ms, %.2f MB (%s, %d colors)\n",
                    res.milliseconds,
                    double(res.peak_mem_usage) / 1024 / 1024,
                    res.success ? "success" : "fail",
                    res.num_colors);
+            if (!res.success)
+                printf("%" PRIu64 " conflicting edges\n", res.num_conflicts);
+            if (res.num_out_of_range != 0)
+                printf("%" PRIu64 " vertices uncolored or with a color above the maximum degree\n", res.num_out_of_range);
+            std::string details = s->details();
+            if (!details.empty())
+                printf("%s\n", details.c_str());
+            printf("\n");
         } else if (settings.output == settings.USE_CSV) {
             struct result res = run_single(s);
-            printf("%s,%d,%d,%s,%.2f,%.2f,%d,%d\n",
+            auto [rounds, round_sizes] = round_columns(s);
+            printf("%s,%" PRIu64 ",%" PRIu64 ",%s,%.2f,%.2f,%d,%d,%s,%s,%s,%s\n",
                    settings.parse_md->filename.c_str(), settings.parse_md->num_vertices, settings.parse_md->num_edges,
                    s->name().c_str(),
                    res.milliseconds,
                    double(res.peak_mem_usage) / 1024 / 1024,
                    res.success,
-                   res.num_colors);
+                   res.num_colors,
+                   settings.ordering.c_str(),
+                   page_size.c_str(),
+                   rounds.c_str(),
+                   round_sizes.c_str());
             std::cout.flush();
         } else if (settings.output == settings.USE_CSV_COMPACT) {
             struct result res = run_single(s);
-            printf("%s,%.2f,%.2f,%d,%d,",
+            auto [rounds, round_sizes] = round_columns(s);
+            printf("%s,%.2f,%.2f,%d,%d,%s,%s,",
                    s->name().c_str(),
                    res.milliseconds,
                    double(res.peak_mem_usage) / 1024 / 1024,
                    res.success,
-                   res.num_colors);
+                   res.num_colors,
+                   rounds.c_str(),
+                   round_sizes.c_str());
             std::cout.flush();
         }
         delete s;
@@ -80,18 +143,27 @@ void Benchmark::run() {
 }
 
 struct result Benchmark::run_single(Solver *solver) {
+    // Allocate the coloring before starting the monitor, so that only the memory used by the solver is measured
+    Coloring coloring(graph ? graph->num_vertices() : compressed->num_vertices());
     MemoryMonitor monitor;
 
     auto t1 = std::chrono::high_resolution_clock::now();
-    solver->solve(graph);
+    if (graph)
+        solver->solve(*graph, coloring);
+    else
+        solver->solve(*compressed, coloring);
     auto t2 = std::chrono::high_resolution_clock::now();
     monitor.stop();
 
-    bool success = graph.is_well_colored();
-    uint32_t num_colors = graph.count_colors();
+    // Validate the coloring and count colors in parallel; on large graphs a sequential scan takes longer than the fast solvers
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    ColoringStats stats = graph ? ColoringStats(*graph, coloring, num_threads) : ColoringStats(*compressed, coloring, num_threads);
     double milliseconds = std::chrono::duration<double, std::milli>(t2 - t1).count();
     // Subtract the memory usage from other data structures in the program
     uint64_t mem_usage = monitor.delta();
-    graph.clear();
-    return {success, num_colors, milliseconds, mem_usage};
+    if (settings.keep_best && stats.is_valid() && (!best || stats.num_colors < best_num_colors)) {
+        best = std::make_unique<Coloring>(std::move(coloring));
+        best_num_colors = stats.num_colors;
+    }
+    return {stats.is_valid(), stats.num_colors, stats.num_conflicts, stats.num_out_of_range, milliseconds, mem_usage};
 }
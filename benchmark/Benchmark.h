@@ -3,10 +3,15 @@
 
 #include "../parse/Parser.h"
 #include "../solve/Solver.h"
+#include <memory>
+#include <utility>
 
 struct result {
     bool success;
     uint32_t num_colors;
+    uint64_t num_conflicts;
+    // Vertices left uncolored, or with a color above the maximum degree (see ColoringStats)
+    uint64_t num_out_of_range;
     double milliseconds;
     uint64_t peak_mem_usage;
 };
@@ -14,21 +19,44 @@ struct result {
 class Benchmark {
     std::vector<Solver *> solvers;
 
-    Graph graph;
+    // Exactly one of the two is set: solvers work either on the plain or on the compressed graph
+    const Graph *graph = nullptr;
+    const CompressedGraph *compressed = nullptr;
+
+    // The valid coloring with the fewest colors so far, if settings.keep_best is set
+    std::unique_ptr<Coloring> best;
+    uint32_t best_num_colors = 0;
+
+    static std::vector<Solver *> default_solvers();
 
     // Return the number of milliseconds when using the given solver
     struct result run_single(Solver *);
 
+    // CSV columns with the number of rounds of the last run and the space-separated number of vertices left at the
+    // start of each, or empty ones if the solver does not work in rounds
+    static std::pair<std::string, std::string> round_columns(const Solver *);
+
   public:
-    Benchmark(Graph &);
+    Benchmark(const Graph &);
+    // Only the solvers that support compressed graphs are run
+    Benchmark(const CompressedGraph &);
 
     void run();
 
+    // The best coloring found by run(), or nullptr if none was valid (or keep_best is not set)
+    const Coloring *best_coloring() const { return best.get(); }
+
     struct {
         enum { USE_TEXT,
                USE_CSV,
-               USE_CSV_COMPACT } output;
-        Parser::metadata_t *parse_md;
+               USE_CSV_COMPACT } output = USE_TEXT;
+        Parser::metadata_t *parse_md = nullptr;
+        // Vertex ordering applied before solving (see Reordering)
+        std::string ordering;
+        // Keep the best coloring, eg. to write it out
+        bool keep_best = false;
+        // If set, only WarmStartSolver runs, starting from this coloring
+        const Coloring *warm_start = nullptr;
     } settings;
 };
 
@@ -1,12 +1,15 @@
 #ifndef GRAPH_COLORING_MEMORYMONITOR_H
 #define GRAPH_COLORING_MEMORYMONITOR_H
 
+#include <atomic>
 #include <cstdint>
 #include <thread>
 
 class MemoryMonitor {
-    int64_t peak_usage, baseline;
-    bool stopped;
+    // Written by the monitor thread while the main thread may read them
+    std::atomic<int64_t> peak_usage;
+    int64_t baseline;
+    std::atomic<bool> stopped;
 
     std::thread thread;
 
@@ -0,0 +1,8 @@
+#include "Coloring.h"
+
+Coloring::Coloring(vertex_t num_vertices) : colors(num_vertices) {}
+
+void Coloring::clear() {
+    for (auto &color : colors)
+        color.store(0, std::memory_order_relaxed);
+}
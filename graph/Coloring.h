@@ -0,0 +1,47 @@
+#ifndef GRAPH_COLORING_COLORING_H
+#define GRAPH_COLORING_COLORING_H
+
+#include "FirstFit.h"
+#include "Graph.h"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/* Coloring holds the color of each vertex of a graph. Keeping it apart from Graph allows the graph to be shared as
+ * a const object, eg. by several solvers running at the same time, each writing to its own Coloring.
+ *
+ * Speculative solvers color vertices from several threads while other threads read the neighbors' colors, so colors
+ * are stored as atomics. Relaxed ordering is enough (a stale read only causes a conflict, which solvers detect and
+ * fix afterwards) and compiles to plain loads and stores on x86.
+ *
+ * Validation and statistics (conflicts, number of colors, class sizes) are computed by ColoringStats.
+ */
+class Coloring {
+    policy_vector<std::atomic<color_t>> colors;
+
+  public:
+    // Marks the vertices that have no color yet, eg. those missing from a warm-start coloring. First-fit ignores it,
+    // since it is above any degree.
+    static constexpr color_t UNCOLORED = std::numeric_limits<color_t>::max();
+
+    Coloring(vertex_t num_vertices);
+
+    vertex_t num_vertices() const { return colors.size(); }
+    color_t color_of(vertex_t v) const { return colors[v].load(std::memory_order_relaxed); }
+    void set_color(vertex_t v, color_t color) { colors[v].store(color, std::memory_order_relaxed); }
+
+    // Color vertex v with the smallest color that is not the same as a neighbor's, and return the color.
+    // G may be a Graph or a CompressedGraph.
+    template <typename G>
+    color_t color_with_smallest(const G &graph, vertex_t v) {
+        color_t smallest_color = FirstFit::smallest_free(graph.neighbors_of(v), [this](vertex_t neighbor) { return color_of(neighbor); });
+        set_color(v, smallest_color);
+        return smallest_color;
+    }
+
+    // Reset the coloring for usage by another algorithm
+    void clear();
+};
+
+#endif //GRAPH_COLORING_COLORING_H
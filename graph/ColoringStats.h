@@ -0,0 +1,112 @@
+#ifndef GRAPH_COLORING_COLORINGSTATS_H
+#define GRAPH_COLORING_COLORINGSTATS_H
+
+#include "../utils/RangeSplitter.h"
+#include "Coloring.h"
+#include "Graph.h"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/* ColoringStats validates a coloring and collects statistics about it in a single parallel pass over the edges: each
+ * thread scans a range of vertices, counting conflicts and building its own histogram of color classes, and the
+ * partial results are merged at the end.
+ *
+ * Graphs are symmetric, so each conflicting edge {u, v} is seen from both endpoints; it is only counted from the one
+ * with the lower ID. A self-loop is always a conflict.
+ *
+ * First-fit never gives a vertex a color above its degree, so no solver needs colors above the maximum degree, and the
+ * histogram is capped there: its size does not depend on the color values, which may come from a file (see
+ * ColoringFile). Colors above the cap, including UNCOLORED, are counted separately and make the coloring invalid.
+ */
+class ColoringStats {
+  public:
+    using edge_t = std::pair<vertex_t, vertex_t>;
+
+    // Number of edges whose endpoints have the same color
+    uint64_t num_conflicts = 0;
+    // Number of vertices whose color is above the maximum degree, or UNCOLORED
+    uint64_t num_out_of_range = 0;
+    // The first conflicting edges (u <= v, sorted), up to the limit given to the constructor
+    std::vector<edge_t> conflict_edges;
+    // Number of distinct colors, and the largest one
+    uint32_t num_colors = 0;
+    color_t max_color = 0;
+    // class_sizes[c] is the number of vertices with color c
+    std::vector<uint64_t> class_sizes;
+
+    // G may be a Graph or a CompressedGraph
+    template <typename G>
+    ColoringStats(const G &graph, const Coloring &coloring, int num_threads = 1, size_t max_conflict_edges = 1024);
+
+    bool is_valid() const { return num_conflicts == 0 && num_out_of_range == 0; }
+};
+
+template <typename G>
+ColoringStats::ColoringStats(const G &graph, const Coloring &coloring, int num_threads, size_t max_conflict_edges) {
+    struct partial_t {
+        uint64_t num_conflicts = 0, num_out_of_range = 0;
+        std::vector<edge_t> conflict_edges;
+        std::vector<uint64_t> class_sizes;
+        vertex_t max_degree = 0;
+    };
+    std::vector<partial_t> partials(num_threads);
+
+    parallel_for(graph.num_vertices(), num_threads, [&](int thread_idx, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; vertex++)
+            partials[thread_idx].max_degree = std::max(partials[thread_idx].max_degree, graph.degree_of(vertex));
+    });
+    vertex_t max_degree = 0;
+    for (const auto &partial : partials)
+        max_degree = std::max(max_degree, partial.max_degree);
+    const uint64_t max_valid_color = max_degree;
+
+    parallel_for(graph.num_vertices(), num_threads, [&](int thread_idx, uint64_t from, uint64_t to) {
+        partial_t &partial = partials[thread_idx];
+        for (vertex_t vertex = from; vertex < to; vertex++) {
+            color_t color = coloring.color_of(vertex);
+            if (color > max_valid_color) {
+                partial.num_out_of_range++;
+            } else {
+                if (color >= partial.class_sizes.size())
+                    partial.class_sizes.resize(size_t(color) + 1, 0);
+                partial.class_sizes[color]++;
+            }
+
+            // Count without branching; conflicts are rare, so the edge list is only built when there are some
+            uint64_t vertex_conflicts = 0;
+            for (vertex_t neighbor : graph.neighbors_of(vertex))
+                vertex_conflicts += (neighbor >= vertex) & (coloring.color_of(neighbor) == color);
+            if (vertex_conflicts == 0)
+                continue;
+            partial.num_conflicts += vertex_conflicts;
+            for (vertex_t neighbor : graph.neighbors_of(vertex)) {
+                if (partial.conflict_edges.size() == max_conflict_edges)
+                    break;
+                if (neighbor >= vertex && coloring.color_of(neighbor) == color)
+                    partial.conflict_edges.emplace_back(vertex, neighbor);
+            }
+        }
+    });
+
+    for (const auto &partial : partials) {
+        num_conflicts += partial.num_conflicts;
+        num_out_of_range += partial.num_out_of_range;
+        conflict_edges.insert(conflict_edges.end(), partial.conflict_edges.begin(), partial.conflict_edges.end());
+        if (partial.class_sizes.size() > class_sizes.size())
+            class_sizes.resize(partial.class_sizes.size(), 0);
+        for (size_t color = 0; color < partial.class_sizes.size(); color++)
+            class_sizes[color] += partial.class_sizes[color];
+    }
+    // Threads cover increasing vertex ranges, so this keeps the edges with the lowest IDs
+    std::sort(conflict_edges.begin(), conflict_edges.end());
+    if (conflict_edges.size() > max_conflict_edges)
+        conflict_edges.resize(max_conflict_edges);
+
+    if (!class_sizes.empty())
+        max_color = class_sizes.size() - 1;
+    num_colors = std::count_if(class_sizes.begin(), class_sizes.end(), [](uint64_t size) { return size != 0; });
+}
+
+#endif //GRAPH_COLORING_COLORINGSTATS_H
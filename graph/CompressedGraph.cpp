@@ -0,0 +1,71 @@
+#include "CompressedGraph.h"
+#include "../utils/RangeSplitter.h"
+#include <algorithm>
+
+// Encode a sorted adjacency list, calling emit(value) for each varint
+template <typename V, typename Emit>
+static void encode_list(V vertex, nonstd::span<const V> neighbors, Emit &&emit) {
+    emit(neighbors.size());
+    if (neighbors.empty())
+        return;
+    int64_t first = int64_t(neighbors[0]) - int64_t(vertex);
+    emit((uint64_t(first) << 1) ^ uint64_t(first >> 63));
+    for (size_t idx = 1; idx < neighbors.size(); idx++)
+        emit(neighbors[idx] - neighbors[idx - 1]);
+}
+
+static int varint_size(uint64_t value) {
+    int size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+template <typename V, typename O>
+BasicCompressedGraph<V, O>::BasicCompressedGraph(const BasicGraph<V, O> &graph, int num_threads)
+    : offsets(size_t(graph.num_vertices()) + 1, 0), num_directed_edges(graph.num_edges()) {
+    V num_vertices = graph.num_vertices();
+
+    // Lists must be sorted for the gaps to be non-negative; the parsers sort them, but other sources may not
+    auto sorted_neighbors = [&graph](V vertex, std::vector<V> &buffer) {
+        auto neighbors = graph.neighbors_of(vertex);
+        if (std::is_sorted(neighbors.begin(), neighbors.end()))
+            return neighbors;
+        buffer.assign(neighbors.begin(), neighbors.end());
+        std::sort(buffer.begin(), buffer.end());
+        return nonstd::span<const V>(buffer.data(), buffer.size());
+    };
+
+    // First pass: compute the encoded size of each list, then the offsets with a prefix sum
+    parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+        std::vector<V> buffer;
+        for (V vertex = from; vertex < to; vertex++) {
+            O size = 0;
+            encode_list(vertex, sorted_neighbors(vertex, buffer), [&size](uint64_t value) { size += varint_size(value); });
+            offsets[vertex + 1] = size;
+        }
+    });
+    for (V vertex = 0; vertex < num_vertices; vertex++)
+        offsets[vertex + 1] += offsets[vertex];
+    data.resize(offsets.back());
+
+    // Second pass: encode each list into its slot
+    parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+        std::vector<V> buffer;
+        for (V vertex = from; vertex < to; vertex++) {
+            uint8_t *pos = data.data() + offsets[vertex];
+            encode_list(vertex, sorted_neighbors(vertex, buffer), [&pos](uint64_t value) {
+                while (value >= 0x80) {
+                    *pos++ = uint8_t(value) | 0x80;
+                    value >>= 7;
+                }
+                *pos++ = uint8_t(value);
+            });
+        }
+    });
+}
+
+// Only the configured instantiation is compiled
+template class BasicCompressedGraph<vertex_t, offset_t>;
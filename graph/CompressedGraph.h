@@ -0,0 +1,102 @@
+#ifndef GRAPH_COLORING_COMPRESSEDGRAPH_H
+#define GRAPH_COLORING_COMPRESSEDGRAPH_H
+
+#include "Graph.h"
+#include <cstdint>
+#include <vector>
+
+/* CompressedNeighbors is a range over a gap-encoded adjacency list, decoded on the fly while iterating.
+ * It can be used in place of the span returned by Graph::neighbors_of in range-based for loops.
+ */
+template <typename V>
+class CompressedNeighbors {
+    const uint8_t *data;
+    V vertex, degree;
+
+  public:
+    // Decode an unsigned LEB128 varint (7 bits per byte, high bit set on all bytes but the last) and advance pos
+    static uint64_t decode_varint(const uint8_t *&pos) {
+        uint64_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t byte = *pos++;
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+    }
+
+    class sentinel {};
+
+    class iterator {
+        const uint8_t *pos;
+        V remaining, current;
+
+      public:
+        iterator(const uint8_t *pos, V vertex, V degree) : pos(pos), remaining(degree), current(0) {
+            // The first neighbor is stored as a zigzag-encoded difference from the vertex itself
+            if (remaining != 0) {
+                uint64_t zigzag = decode_varint(this->pos);
+                current = vertex + V(int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1));
+            }
+        }
+
+        V operator*() const { return current; }
+        iterator &operator++() {
+            // The following ones are stored as the (non-negative) gap from the previous neighbor
+            if (--remaining != 0)
+                current += decode_varint(pos);
+            return *this;
+        }
+        bool operator==(sentinel) const { return remaining == 0; }
+        bool operator!=(sentinel) const { return remaining != 0; }
+    };
+
+    CompressedNeighbors(const uint8_t *data, V vertex, V degree) : data(data), vertex(vertex), degree(degree) {}
+
+    V size() const { return degree; }
+    bool empty() const { return degree == 0; }
+    iterator begin() const { return iterator(data, vertex, degree); }
+    sentinel end() const { return {}; }
+};
+
+/* BasicCompressedGraph stores the same data as BasicGraph, but each adjacency list is encoded as a sequence of
+ * varints: the degree, then the difference between the first neighbor and the vertex (zigzag-encoded, as it may be
+ * negative), then the gaps between consecutive neighbors. Since adjacency lists are sorted, gaps are small, and most
+ * fit in a single byte; graphs with good locality (eg. after Reordering) compress best.
+ *
+ * The interface mirrors BasicGraph, except that neighbors_of returns a CompressedNeighbors range which only supports
+ * forward iteration.
+ */
+template <typename V, typename O>
+class BasicCompressedGraph {
+    // offsets[v] is the byte position in `data` where the list of v starts
+    policy_vector<O> offsets;
+    policy_vector<uint8_t> data;
+    O num_directed_edges;
+
+  public:
+    using vertex_type = V;
+    using offset_type = O;
+
+    // Encode a graph; adjacency lists are encoded in parallel
+    BasicCompressedGraph(const BasicGraph<V, O> &, int num_threads = 1);
+
+    V num_vertices() const { return offsets.size() - 1; }
+    O num_edges() const { return num_directed_edges; }
+    // Size of the encoded adjacency lists in bytes
+    O num_bytes() const { return data.size(); }
+
+    V degree_of(V v) const {
+        const uint8_t *pos = data.data() + offsets[v];
+        return CompressedNeighbors<V>::decode_varint(pos);
+    }
+    CompressedNeighbors<V> neighbors_of(V v) const {
+        const uint8_t *pos = data.data() + offsets[v];
+        V degree = CompressedNeighbors<V>::decode_varint(pos);
+        return CompressedNeighbors<V>(pos, v, degree);
+    }
+};
+
+using CompressedGraph = BasicCompressedGraph<vertex_t, offset_t>;
+
+#endif //GRAPH_COLORING_COMPRESSEDGRAPH_H
@@ -0,0 +1,73 @@
+#ifndef GRAPH_COLORING_FIRSTFIT_H
+#define GRAPH_COLORING_FIRSTFIT_H
+
+#include "Graph.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+/* First-fit kernel shared by all solvers: find the smallest color that no neighbor uses.
+ *
+ * A vertex with degree d always has a free color in [0, d], so only colors up to d need to be tracked. For most
+ * vertices these fit in a small bitmask of forbidden colors, which is scanned one 64-bit word at a time (countr_one
+ * compiles to tzcnt). High-degree vertices use a per-thread array of epoch stamps instead: a color is forbidden if
+ * its stamp equals the current epoch, so the array never needs to be cleared between calls.
+ */
+class FirstFit {
+    static constexpr size_t MASK_WORDS = 8;
+
+    struct stamps_t {
+        std::vector<uint32_t> stamps;
+        uint32_t epoch = 0;
+    };
+
+    static stamps_t &thread_stamps() {
+        thread_local stamps_t stamps;
+        return stamps;
+    }
+
+  public:
+    // Largest degree handled by the bitmask path
+    static constexpr size_t MAX_MASK_DEGREE = MASK_WORDS * 64 - 1;
+
+    // Return the smallest color not in {color_of(n) for n in neighbors}. Neighbors may be any range with a size(),
+    // eg. a span from Graph or a CompressedNeighbors range.
+    template <typename Range, typename ColorOf>
+    static color_t smallest_free(const Range &neighbors, ColorOf &&color_of) {
+        const uint64_t degree = neighbors.size();
+
+        if (degree <= MAX_MASK_DEGREE) {
+            uint64_t forbidden[MASK_WORDS] = {};
+            for (auto neighbor : neighbors) {
+                uint64_t color = color_of(neighbor);
+                if (color <= degree)
+                    forbidden[color / 64] |= uint64_t(1) << (color % 64);
+            }
+            // At most `degree` bits are set among the first degree + 1, so this finds a free color within the mask
+            for (size_t word = 0;; word++)
+                if (~forbidden[word] != 0)
+                    return word * 64 + std::countr_one(forbidden[word]);
+        }
+
+        stamps_t &state = thread_stamps();
+        if (state.stamps.size() <= degree)
+            state.stamps.resize(degree + 1, 0);
+        // Stamps from previous calls must never match the current epoch, so reset them if the counter wraps around
+        if (++state.epoch == 0) {
+            std::fill(state.stamps.begin(), state.stamps.end(), 0);
+            state.epoch = 1;
+        }
+        for (auto neighbor : neighbors) {
+            uint64_t color = color_of(neighbor);
+            if (color <= degree)
+                state.stamps[color] = state.epoch;
+        }
+        color_t color = 0;
+        while (state.stamps[color] == state.epoch)
+            color++;
+        return color;
+    }
+};
+
+#endif //GRAPH_COLORING_FIRSTFIT_H
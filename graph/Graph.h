@@ -1,59 +1,107 @@
 #ifndef GRAPH_COLORING_GRAPH_H
 #define GRAPH_COLORING_GRAPH_H
 
+#include "../utils/PageAllocator.h"
 #include "../utils/span-lite.hpp"
-#include <bitset>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
-using adjacency_vec_t = std::vector<uint32_t>;
-using adjacency_list_t = nonstd::span<uint32_t>;
+// The widths of vertex IDs and edge offsets are chosen at compile time (see CMakeLists.txt), so that the solvers'
+// hot loops are specialized for a single instantiation of BasicGraph.
+#ifndef GRAPH_VERTEX_BITS
+#define GRAPH_VERTEX_BITS 32
+#endif
+#ifndef GRAPH_OFFSET_BITS
+#define GRAPH_OFFSET_BITS 64
+#endif
+
+template <int bits>
+struct uint_of_width;
+template <>
+struct uint_of_width<16> { using type = uint16_t; };
+template <>
+struct uint_of_width<32> { using type = uint32_t; };
+template <>
+struct uint_of_width<64> { using type = uint64_t; };
+
+using vertex_t = uint_of_width<GRAPH_VERTEX_BITS>::type;
+using offset_t = uint_of_width<GRAPH_OFFSET_BITS>::type;
 using color_t = uint32_t;
 
-/* Graph implements the CSR data structure: we have a vector `neighbors` which holds all vertices' neighbors in sequence,
- * and a vector `neighbor_indices` which for each vertex points to the range in `vertices` where its neighbors lie.
- */
-class Graph {
-    std::vector<uint32_t> neighbors;
-    std::vector<adjacency_list_t> neighbor_indices;
-    std::vector<color_t> colors;
-
-    friend class DeletableGraph;
-    friend class Serializer;
-    friend class Parser;
+using adjacency_vec_t = std::vector<vertex_t>;
+using adjacency_list_t = nonstd::span<const vertex_t>;
 
-    // MIS-based solvers color vertices directly rather than via color_with_smallest
-    friend class LubySolver;
+/* BasicGraph implements the CSR data structure: we have a vector `neighbors` which holds all vertices' neighbors in
+ * sequence, and a vector `offsets` such that the neighbors of v lie in [offsets[v], offsets[v + 1]).
+ * V is the type of vertex IDs (which bounds the number of vertices), O the type of offsets (which bounds the number of
+ * directed edges). Note that the largest value of V is reserved, so that a vertex count always fits in V.
+ *
+ * A graph either owns its arrays, or is a read-only view over arrays stored elsewhere (eg. in a memory-mapped .fast
+ * file, see FastParser), in which case it keeps a reference to their storage. Accessors work the same in both cases.
+ */
+template <typename V, typename O>
+class BasicGraph {
+    policy_vector<O> offsets;
+    policy_vector<V> neighbors;
+    // Keeps the arrays of a view alive; empty if the graph owns its arrays
+    std::shared_ptr<const void> storage;
+    const O *offsets_data;
+    const V *neighbors_data;
+    V vertex_count;
+    O edge_count;
 
   public:
-    Graph(const std::vector<adjacency_vec_t> &adj_list);
-
-    bool is_well_colored() const;
-    uint32_t count_colors() const;
-
-    uint32_t num_vertices() const;
-    color_t color_of(uint32_t v) const;
-    adjacency_list_t neighbors_of(uint32_t v) const;
-    uint32_t degree_of(uint32_t v) const;
-
-    // Color vertex v with the smallest color that is not the same as a neighbor's, and return the color
-    color_t color_with_smallest(uint32_t v);
-
-    // Reset the graph for usage by another algorithm. Clears colors
-    void clear();
+    using vertex_type = V;
+    using offset_type = O;
+
+    // Takes ownership of CSR arrays, usually produced by GraphBuilder: the neighbors of v are in [offsets[v], offsets[v + 1])
+    BasicGraph(policy_vector<O> &&offsets, policy_vector<V> &&neighbors);
+    // Create a view over CSR arrays owned by `storage`: offsets has num_vertices + 1 entries, neighbors has num_edges
+    BasicGraph(std::shared_ptr<const void> storage, const O *offsets, const V *neighbors, V num_vertices, O num_edges);
+
+    // Views share their storage, but owned arrays would have to be copied: graphs are only moved
+    BasicGraph(const BasicGraph &) = delete;
+    BasicGraph &operator=(const BasicGraph &) = delete;
+    BasicGraph(BasicGraph &&) = default;
+    BasicGraph &operator=(BasicGraph &&) = default;
+
+    V num_vertices() const { return vertex_count; }
+    // Number of directed edges, i.e. twice the number of undirected edges
+    O num_edges() const { return edge_count; }
+    nonstd::span<const V> neighbors_of(V v) const { return {neighbors_data + offsets_data[v], neighbors_data + offsets_data[v + 1]}; }
+    V degree_of(V v) const { return offsets_data[v + 1] - offsets_data[v]; }
+
+    // Whether the arrays are stored elsewhere (eg. memory-mapped) rather than owned
+    bool is_view() const { return storage != nullptr; }
+    // The raw CSR arrays, eg. for serialization
+    nonstd::span<const O> offsets_array() const { return {offsets_data, size_t(vertex_count) + 1}; }
+    nonstd::span<const V> neighbors_array() const { return {neighbors_data, size_t(edge_count)}; }
 };
 
+using Graph = BasicGraph<vertex_t, offset_t>;
+
+/* DeletableGraph marks vertices as deleted without touching the underlying graph. Besides the deleted flags (one bit
+ * per vertex), it keeps the number of live vertices and a list of the remaining ones, which is compacted when read:
+ * iterating over the survivors thus costs O(remaining) rather than O(n).
+ */
 class DeletableGraph {
-    std::bitset<(1 << 24)> deleted; // Note that we support at most 2^24 nodes.
+    std::vector<bool> deleted;
+    vertex_t num_live;
+    // Sorted list of vertices that were alive at the last compaction
+    std::vector<vertex_t> remaining;
 
   public:
     const Graph &graph;
 
     DeletableGraph(const Graph &);
 
-    void delete_vertex(uint32_t v);
-    bool is_deleted(uint32_t v) const;
+    void delete_vertex(vertex_t v);
+    bool is_deleted(vertex_t v) const;
     [[nodiscard]] bool empty() const;
+    vertex_t num_remaining() const;
+    // Drop the deleted vertices from the list of remaining ones, and return it
+    const std::vector<vertex_t> &remaining_vertices();
 
     // Reset the deleted set for usage by another algorithm
     void clear();
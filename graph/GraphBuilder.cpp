@@ -0,0 +1,48 @@
+#include "GraphBuilder.h"
+#include <numeric>
+
+template <typename V, typename O>
+BasicGraphBuilder<V, O>::BasicGraphBuilder(V num_vertices) : offsets(size_t(num_vertices) + 1, 0), appended(0) {}
+
+template <typename V, typename O>
+V BasicGraphBuilder<V, O>::num_vertices() const {
+    return offsets.size() - 1;
+}
+
+template <typename V, typename O>
+void BasicGraphBuilder<V, O>::set_degree(V v, V degree) {
+    offsets[v + 1] = degree;
+}
+
+template <typename V, typename O>
+void BasicGraphBuilder<V, O>::compute_offsets() {
+    // offsets[0] is always zero, so an inclusive scan over the degrees yields the starting positions
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    neighbors.resize(offsets.back());
+}
+
+template <typename V, typename O>
+nonstd::span<V> BasicGraphBuilder<V, O>::neighbors_of(V v) {
+    return nonstd::span<V>(neighbors.data() + offsets[v], neighbors.data() + offsets[v + 1]);
+}
+
+template <typename V, typename O>
+void BasicGraphBuilder<V, O>::reserve(O num_neighbors) {
+    neighbors.reserve(num_neighbors);
+}
+
+template <typename V, typename O>
+nonstd::span<V> BasicGraphBuilder<V, O>::append_row(V degree) {
+    O begin = offsets[appended];
+    offsets[++appended] = begin + degree;
+    neighbors.resize(begin + degree);
+    return nonstd::span<V>(neighbors.data() + begin, neighbors.data() + begin + degree);
+}
+
+template <typename V, typename O>
+BasicGraph<V, O> BasicGraphBuilder<V, O>::build() {
+    return BasicGraph<V, O>(std::move(offsets), std::move(neighbors));
+}
+
+// Only the configured instantiation is compiled
+template class BasicGraphBuilder<vertex_t, offset_t>;
@@ -0,0 +1,157 @@
+#ifndef GRAPH_COLORING_GRAPHBUILDER_H
+#define GRAPH_COLORING_GRAPHBUILDER_H
+
+#include "../parse/FastFormat.h"
+#include "../utils/RangeSplitter.h"
+#include "Graph.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/* GraphBuilder constructs the CSR arrays of a Graph directly, without going through a vector of adjacency vectors.
+ *
+ * Usage is split in three phases:
+ *  1. set_degree() is called once for each vertex (possibly from several threads, for distinct vertices);
+ *  2. compute_offsets() turns the degrees into offsets with a prefix sum and allocates the neighbor array;
+ *  3. neighbors_of() returns the slot where each vertex's neighbors must be written (again, one thread per vertex).
+ * Parsers that read vertices in order with a known degree can use append_row() instead, and parsers that produce
+ * edges in arbitrary order can use symmetrize().
+ */
+template <typename V, typename O>
+class BasicGraphBuilder {
+    // offsets[v] is the position in `neighbors` where the neighbors of v start; offsets[num_vertices] is the total.
+    // Before compute_offsets(), offsets[v + 1] holds the degree of v.
+    policy_vector<O> offsets;
+    policy_vector<V> neighbors;
+    // Number of rows filled with append_row
+    V appended;
+
+  public:
+    BasicGraphBuilder(V num_vertices);
+
+    V num_vertices() const;
+
+    void set_degree(V v, V degree);
+    void compute_offsets();
+    nonstd::span<V> neighbors_of(V v);
+
+    // Reserve space for the neighbor array when the total is known in advance (eg. from the file size)
+    void reserve(O num_neighbors);
+    // Append the next vertex in order and return the slot for its neighbors. The slot is invalidated by the next call.
+    nonstd::span<V> append_row(V degree);
+
+    // Move the arrays into a Graph. The builder is empty afterwards.
+    BasicGraph<V, O> build();
+
+    /* Build an undirected graph from a list of edges, split in num_threads partitions: for_each_edge(thread_idx, emit)
+     * must call emit(u, v) for each edge of the given partition, and produce the same edges every time it is called.
+     * Each edge u-v is stored in the rows of both u and v; rows are then sorted, and duplicate edges removed.
+     *
+     * This is a parallel counting sort: the threads count the edges added to each row in a single array of atomic
+     * counters (so memory does not grow with the number of threads), a prefix sum over the rows gives the offsets, and
+     * the counters are then reused as cursors: each endpoint of an edge takes the next free slot of its row with a
+     * fetch_add. Slots are thus filled in an order that depends on timing, but the rows are sorted afterwards.
+     */
+    template <typename F>
+    static BasicGraph<V, O> symmetrize(V num_vertices, int num_threads, F &&for_each_edge);
+    // Symmetrize an existing graph, whose rows are split by vertex range: each edge is added in both directions
+    static BasicGraph<V, O> symmetrize(const BasicGraph<V, O> &graph, int num_threads);
+
+    /* Whether the graph is symmetric, ie. v is a neighbor of u whenever u is a neighbor of v, up to hash collisions
+     * (with probability about 2^-64). Rather than looking up the reverse of each edge (a random access per edge), the
+     * sum of fast_edge_hash over the edges is compared with that over the reversed edges, which reads the rows once,
+     * in parallel. This is how the SYMMETRIC flag of .fast files is computed.
+     */
+    static bool is_symmetric(const BasicGraph<V, O> &graph, int num_threads);
+};
+
+template <typename V, typename O>
+template <typename F>
+BasicGraph<V, O> BasicGraphBuilder<V, O>::symmetrize(V num_vertices, int num_threads, F &&for_each_edge) {
+    // cursors[v] is first the number of neighbors added to the row of v, and then the index of its next free slot.
+    // Atomics are value-initialized, ie. zeroed.
+    std::unique_ptr<std::atomic<V>[]> cursors(new std::atomic<V>[num_vertices]);
+    parallel_for(num_threads, num_threads, [&](int thread_idx, uint64_t, uint64_t) {
+        for_each_edge(thread_idx, [&cursors](V from, V to) {
+            cursors[from].fetch_add(1, std::memory_order_relaxed);
+            cursors[to].fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+
+    BasicGraphBuilder builder(num_vertices);
+    parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (V vertex = from; vertex < to; vertex++) {
+            builder.set_degree(vertex, cursors[vertex].load(std::memory_order_relaxed));
+            cursors[vertex].store(0, std::memory_order_relaxed);
+        }
+    });
+    builder.compute_offsets();
+
+    parallel_for(num_threads, num_threads, [&](int thread_idx, uint64_t, uint64_t) {
+        for_each_edge(thread_idx, [&builder, &cursors](V from, V to) {
+            builder.neighbors[builder.offsets[from] + cursors[from].fetch_add(1, std::memory_order_relaxed)] = to;
+            builder.neighbors[builder.offsets[to] + cursors[to].fetch_add(1, std::memory_order_relaxed)] = from;
+        });
+    });
+    cursors.reset();
+
+    // Sort each row and move duplicates to its end; unique[v] is the number of distinct neighbors of v
+    std::vector<V> unique(num_vertices);
+    std::vector<O> partial_duplicates(num_threads, 0);
+    parallel_for(num_vertices, num_threads, [&](int thread_idx, uint64_t from, uint64_t to) {
+        for (V vertex = from; vertex < to; vertex++) {
+            auto row = builder.neighbors_of(vertex);
+            std::sort(row.begin(), row.end());
+            unique[vertex] = std::unique(row.begin(), row.end()) - row.begin();
+            partial_duplicates[thread_idx] += row.size() - unique[vertex];
+        }
+    });
+    bool has_duplicates = std::any_of(partial_duplicates.begin(), partial_duplicates.end(), [](O count) { return count != 0; });
+    if (!has_duplicates)
+        return builder.build();
+
+    // Rows shrink, so they are copied into smaller arrays
+    BasicGraphBuilder compact(num_vertices);
+    parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (V vertex = from; vertex < to; vertex++)
+            compact.set_degree(vertex, unique[vertex]);
+    });
+    compact.compute_offsets();
+    parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (V vertex = from; vertex < to; vertex++) {
+            auto row = builder.neighbors_of(vertex);
+            std::copy(row.begin(), row.begin() + unique[vertex], compact.neighbors_of(vertex).begin());
+        }
+    });
+    return compact.build();
+}
+
+template <typename V, typename O>
+BasicGraph<V, O> BasicGraphBuilder<V, O>::symmetrize(const BasicGraph<V, O> &graph, int num_threads) {
+    V num_vertices = graph.num_vertices();
+    return symmetrize(num_vertices, num_threads, [&graph, num_vertices, num_threads](int thread_idx, auto &&emit) {
+        RangeSplitter rs(num_vertices, num_threads);
+        for (V vertex = rs.get_min(thread_idx); vertex < rs.get_max(thread_idx); vertex++)
+            for (V neighbor : graph.neighbors_of(vertex))
+                emit(vertex, neighbor);
+    });
+}
+
+template <typename V, typename O>
+bool BasicGraphBuilder<V, O>::is_symmetric(const BasicGraph<V, O> &graph, int num_threads) {
+    std::atomic<uint64_t> difference = 0;
+    parallel_for(graph.num_vertices(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        uint64_t partial = 0;
+        for (V vertex = from; vertex < to; vertex++)
+            for (V neighbor : graph.neighbors_of(vertex))
+                partial += fast_edge_hash(vertex, neighbor) - fast_edge_hash(neighbor, vertex);
+        difference.fetch_add(partial, std::memory_order_relaxed);
+    });
+    return difference == 0;
+}
+
+using GraphBuilder = BasicGraphBuilder<vertex_t, offset_t>;
+
+#endif //GRAPH_COLORING_GRAPHBUILDER_H
@@ -0,0 +1,216 @@
+#include "Reordering.h"
+#include "../utils/RangeSplitter.h"
+#include "GraphBuilder.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+
+// Below this frontier size, a BFS level is expanded on the calling thread: spawning threads would cost more
+static const size_t PARALLEL_FRONTIER_SIZE = 4096;
+
+Reordering::Reordering(const Graph &graph, strategy_t strategy, int num_threads) : num_threads(num_threads) {
+    switch (strategy) {
+    case BFS:
+        compute_bfs(graph);
+        break;
+    case RCM:
+        compute_rcm(graph);
+        break;
+    case DEGREE:
+        compute_degree(graph);
+        break;
+    }
+    invert();
+}
+
+Reordering::strategy_t Reordering::parse_strategy(const std::string &name) {
+    if (name == "bfs")
+        return BFS;
+    if (name == "rcm")
+        return RCM;
+    if (name == "degree")
+        return DEGREE;
+    throw std::runtime_error("Unknown vertex ordering: " + name);
+}
+
+std::string Reordering::strategy_name(strategy_t strategy) {
+    switch (strategy) {
+    case BFS:
+        return "bfs";
+    case RCM:
+        return "rcm";
+    case DEGREE:
+        return "degree";
+    }
+    return "";
+}
+
+void Reordering::compute_bfs(const Graph &graph) {
+    vertex_t num_vertices = graph.num_vertices();
+    std::vector<std::atomic<bool>> visited(num_vertices);
+    // While v is claimed in parallel, parents[v] is 1 + the smallest index in the frontier of a neighbor of v (0 until
+    // one is found). Each vertex is claimed in a single level, so the array is never reset.
+    std::vector<std::atomic<vertex_t>> parents(num_threads > 1 ? num_vertices : 0);
+    old_ids.clear();
+    old_ids.reserve(num_vertices);
+
+    std::vector<vertex_t> frontier;
+    std::vector<std::vector<vertex_t>> partial_frontiers(num_threads);
+    // Start a new BFS from the first unvisited vertex of each connected component
+    for (vertex_t root = 0; root < num_vertices; root++) {
+        if (visited[root].load(std::memory_order_relaxed))
+            continue;
+        visited[root].store(true, std::memory_order_relaxed);
+        frontier.assign(1, root);
+
+        // Level-synchronous BFS: vertices in each level are numbered before those in the next one
+        while (!frontier.empty()) {
+            old_ids.insert(old_ids.end(), frontier.begin(), frontier.end());
+
+            if (num_threads == 1 || frontier.size() < PARALLEL_FRONTIER_SIZE) {
+                std::vector<vertex_t> next;
+                for (vertex_t vertex : frontier)
+                    for (vertex_t neighbor : graph.neighbors_of(vertex))
+                        if (!visited[neighbor].load(std::memory_order_relaxed)) {
+                            visited[neighbor].store(true, std::memory_order_relaxed);
+                            next.push_back(neighbor);
+                        }
+                frontier = std::move(next);
+                continue;
+            }
+
+            // Each unvisited neighbor is claimed by the first vertex of the frontier that reaches it, as in the
+            // sequential BFS, whatever the timing: a first pass keeps the smallest index of a parent for each of them
+            parallel_for(frontier.size(), num_threads, [&](int, uint64_t from, uint64_t to) {
+                for (uint64_t idx = from; idx < to; idx++)
+                    for (vertex_t neighbor : graph.neighbors_of(frontier[idx])) {
+                        if (visited[neighbor].load(std::memory_order_relaxed))
+                            continue;
+                        vertex_t parent = parents[neighbor].load(std::memory_order_relaxed);
+                        while ((parent == 0 || idx + 1 < parent) && !parents[neighbor].compare_exchange_weak(parent, idx + 1, std::memory_order_relaxed)) {}
+                    }
+            });
+            // Then each thread collects the vertices claimed by its slice of the frontier, in order, so that the
+            // concatenated slices give the same level as the sequential BFS
+            parallel_for(frontier.size(), num_threads, [&](int thread_idx, uint64_t from, uint64_t to) {
+                auto &next = partial_frontiers[thread_idx];
+                next.clear();
+                for (uint64_t idx = from; idx < to; idx++)
+                    for (vertex_t neighbor : graph.neighbors_of(frontier[idx]))
+                        // exchange() skips a neighbor listed twice
+                        if (parents[neighbor].load(std::memory_order_relaxed) == idx + 1 && !visited[neighbor].exchange(true, std::memory_order_relaxed))
+                            next.push_back(neighbor);
+            });
+            frontier.clear();
+            for (const auto &next : partial_frontiers)
+                frontier.insert(frontier.end(), next.begin(), next.end());
+        }
+    }
+}
+
+void Reordering::compute_rcm(const Graph &graph) {
+    vertex_t num_vertices = graph.num_vertices();
+    std::vector<bool> visited(num_vertices);
+    old_ids.clear();
+    old_ids.reserve(num_vertices);
+
+    // Each component is started from a vertex of minimum degree, which is a cheap approximation of a peripheral vertex
+    std::vector<vertex_t> by_degree = sort_by_degree(graph);
+    std::vector<vertex_t> children;
+    for (auto root = by_degree.rbegin(); root != by_degree.rend(); ++root) {
+        if (visited[*root])
+            continue;
+        visited[*root] = true;
+        // old_ids doubles as the BFS queue: vertices in [head, end) are yet to be expanded
+        size_t head = old_ids.size();
+        old_ids.push_back(*root);
+        while (head < old_ids.size()) {
+            vertex_t vertex = old_ids[head++];
+            children.clear();
+            for (vertex_t neighbor : graph.neighbors_of(vertex))
+                if (!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    children.push_back(neighbor);
+                }
+            std::sort(children.begin(), children.end(), [&](vertex_t a, vertex_t b) {
+                return graph.degree_of(a) < graph.degree_of(b) || (graph.degree_of(a) == graph.degree_of(b) && a < b);
+            });
+            old_ids.insert(old_ids.end(), children.begin(), children.end());
+        }
+    }
+    std::reverse(old_ids.begin(), old_ids.end());
+}
+
+void Reordering::compute_degree(const Graph &graph) {
+    old_ids = sort_by_degree(graph);
+}
+
+std::vector<vertex_t> Reordering::sort_by_degree(const Graph &graph) const {
+    std::vector<vertex_t> order(graph.num_vertices());
+    std::iota(order.begin(), order.end(), 0);
+    auto by_degree = [&](vertex_t a, vertex_t b) {
+        return graph.degree_of(a) > graph.degree_of(b);
+    };
+
+    // Parallel merge sort: each thread sorts a slice, then adjacent slices are merged pairwise.
+    // Both steps are stable, so the result does not depend on the number of threads.
+    RangeSplitter rs(order.size(), num_threads);
+    parallel_for(order.size(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        std::stable_sort(order.begin() + from, order.begin() + to, by_degree);
+    });
+    for (int width = 1; width < num_threads; width *= 2) {
+        int num_merges = (num_threads + 2 * width - 1) / (2 * width);
+        parallel_for(num_merges, num_merges, [&](int merge_idx, uint64_t, uint64_t) {
+            int first = merge_idx * 2 * width;
+            int middle = std::min(first + width, num_threads), last = std::min(first + 2 * width, num_threads);
+            std::inplace_merge(order.begin() + rs.get_min(first), order.begin() + rs.get_min(middle),
+                               order.begin() + rs.get_max(last - 1), by_degree);
+        });
+    }
+    return order;
+}
+
+void Reordering::invert() {
+    new_ids.resize(old_ids.size());
+    parallel_for(old_ids.size(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (uint64_t idx = from; idx < to; idx++)
+            new_ids[old_ids[idx]] = idx;
+    });
+}
+
+Graph Reordering::apply(const Graph &graph) const {
+    vertex_t num_vertices = graph.num_vertices();
+    GraphBuilder builder(num_vertices);
+    parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; vertex++)
+            builder.set_degree(vertex, graph.degree_of(old_ids[vertex]));
+    });
+    builder.compute_offsets();
+    parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; vertex++) {
+            auto old_neighbors = graph.neighbors_of(old_ids[vertex]);
+            auto neighbors = builder.neighbors_of(vertex);
+            std::transform(old_neighbors.begin(), old_neighbors.end(), neighbors.begin(), [this](vertex_t neighbor) {
+                return new_ids[neighbor];
+            });
+            // Keep adjacency lists sorted, as the parsers do
+            std::sort(neighbors.begin(), neighbors.end());
+        }
+    });
+    return builder.build();
+}
+
+Coloring Reordering::restore(const Coloring &coloring) const {
+    Coloring original(coloring.num_vertices());
+    for (vertex_t vertex = 0; vertex < coloring.num_vertices(); vertex++)
+        original.set_color(vertex, coloring.color_of(new_ids[vertex]));
+    return original;
+}
+
+Coloring Reordering::relabel(const Coloring &coloring) const {
+    Coloring relabeled(coloring.num_vertices());
+    for (vertex_t vertex = 0; vertex < coloring.num_vertices(); vertex++)
+        relabeled.set_color(new_ids[vertex], coloring.color_of(vertex));
+    return relabeled;
+}
@@ -0,0 +1,60 @@
+#ifndef GRAPH_COLORING_REORDERING_H
+#define GRAPH_COLORING_REORDERING_H
+
+#include "Coloring.h"
+#include "Graph.h"
+#include <string>
+#include <vector>
+
+/* Reordering relabels the vertices of a graph to improve memory locality: solvers read the colors of all neighbors of
+ * a vertex, and these reads hit the cache more often when neighbors have close IDs.
+ *
+ * Three strategies are available:
+ *  - BFS: vertices are numbered in breadth-first order, so that neighbors end up in the same or adjacent levels;
+ *    levels are expanded in parallel, and give the same order as a sequential BFS whatever the number of threads;
+ *  - RCM: Reverse Cuthill-McKee, a BFS that visits neighbors by increasing degree and is then reversed, which
+ *    minimizes the bandwidth of the adjacency matrix;
+ *  - DEGREE: vertices are sorted by decreasing degree, so that hubs (which are read most often) share cache lines.
+ *
+ * The permutation is kept in both directions, so that a coloring of the relabeled graph can be mapped back to the
+ * original IDs.
+ */
+class Reordering {
+  public:
+    enum strategy_t { BFS,
+                      RCM,
+                      DEGREE };
+
+  private:
+    int num_threads;
+    // new_ids[v] is the ID of v in the relabeled graph; old_ids is the inverse permutation
+    std::vector<vertex_t> new_ids, old_ids;
+
+    void compute_bfs(const Graph &);
+    void compute_rcm(const Graph &);
+    void compute_degree(const Graph &);
+
+    // Sort vertices by decreasing degree (stable, so ties keep their ID order)
+    std::vector<vertex_t> sort_by_degree(const Graph &) const;
+    // Fill new_ids from old_ids
+    void invert();
+
+  public:
+    Reordering(const Graph &, strategy_t, int num_threads = 1);
+
+    // Parse a strategy name ("bfs", "rcm" or "degree")
+    static strategy_t parse_strategy(const std::string &);
+    static std::string strategy_name(strategy_t);
+
+    vertex_t new_id(vertex_t v) const { return new_ids[v]; }
+    vertex_t old_id(vertex_t v) const { return old_ids[v]; }
+
+    // Build the relabeled graph. Adjacency lists are rebuilt in parallel and kept sorted.
+    Graph apply(const Graph &) const;
+    // Map a coloring of the relabeled graph back to the original IDs
+    Coloring restore(const Coloring &) const;
+    // Map a coloring of the original graph (eg. a warm start) to the relabeled IDs
+    Coloring relabel(const Coloring &) const;
+};
+
+#endif //GRAPH_COLORING_REORDERING_H
@@ -1,18 +1,76 @@
 #include "benchmark/Benchmark.h"
+#include "graph/CompressedGraph.h"
+#include "graph/Reordering.h"
+#include "parse/ColoringFile.h"
 #include "parse/Parser.h"
+#include "parse/StreamingConverter.h"
+#include "utils/PageAllocator.h"
 #include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <thread>
 
 int main(int argc, char **argv) {
     std::vector<std::string> args(argv, argv + argc);
     if (args.size() < 2) {
-        std::cerr << "Syntax: " << args[0] << " [--parse-only] [--csv] <graph>" << std::endl;
+        std::cerr << "Syntax: " << args[0] << " [--parse-only] [--csv] [--reorder=bfs|rcm|degree] [--compressed] [--verify] [--pages=default|thp|hugetlb] [--numa=default|first-touch|interleave] [--no-cache] [--cache-dir=<dir>] [--cache-limit=<MB>] [--sanitize[=check]] [--direct-io] [--colors=<file>] [--warm-start=<file>] [--convert [--memory=<MB>]] <graph>" << std::endl;
         return 1;
     }
     bool use_csv = std::find(args.begin(), args.end(), "--csv") != args.end();
     bool parse_only = std::find(args.begin(), args.end(), "--parse-only") != args.end();
+    bool use_compressed = std::find(args.begin(), args.end(), "--compressed") != args.end();
+    bool verify_fast = std::find(args.begin(), args.end(), "--verify") != args.end();
+    auto reorder_arg = std::find_if(args.begin(), args.end(), [](const std::string &arg) { return arg.rfind("--reorder=", 0) == 0; });
+    auto pages_arg = std::find_if(args.begin(), args.end(), [](const std::string &arg) { return arg.rfind("--pages=", 0) == 0; });
+    auto numa_arg = std::find_if(args.begin(), args.end(), [](const std::string &arg) { return arg.rfind("--numa=", 0) == 0; });
+    auto cache_dir_arg = std::find_if(args.begin(), args.end(), [](const std::string &arg) { return arg.rfind("--cache-dir=", 0) == 0; });
+    auto cache_limit_arg = std::find_if(args.begin(), args.end(), [](const std::string &arg) { return arg.rfind("--cache-limit=", 0) == 0; });
+    auto sanitize_arg = std::find_if(args.begin(), args.end(), [](const std::string &arg) { return arg == "--sanitize" || arg == "--sanitize=check"; });
+    auto colors_arg = std::find_if(args.begin(), args.end(), [](const std::string &arg) { return arg.rfind("--colors=", 0) == 0; });
+    auto warm_start_arg = std::find_if(args.begin(), args.end(), [](const std::string &arg) { return arg.rfind("--warm-start=", 0) == 0; });
+    bool convert = std::find(args.begin(), args.end(), "--convert") != args.end();
+    auto memory_arg = std::find_if(args.begin(), args.end(), [](const std::string &arg) { return arg.rfind("--memory=", 0) == 0; });
 
-    Parser p(args.back());
+    if (convert) {
+        // Write the .fast file in bounded memory, without loading the graph. It is written as the cache entry of the
+        // source (see CacheManager), so that later runs on the source load it instead of parsing the text.
+        uint64_t memory_mb = memory_arg != args.end() ? std::stoull(memory_arg->substr(std::string("--memory=").size())) : 1024;
+        bool use_cache = std::find(args.begin(), args.end(), "--no-cache") == args.end();
+        CacheManager cache(cache_dir_arg != args.end() ? cache_dir_arg->substr(std::string("--cache-dir=").size()) : "",
+                           cache_limit_arg != args.end() ? std::stoull(cache_limit_arg->substr(std::string("--cache-limit=").size())) * 1024 * 1024 : ParserOptions().cache_size_limit);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        std::string output = use_cache ? cache.entry_path(args.back(), CacheManager::hash_contents(args.back())) : args.back() + ".fast";
+        if (use_cache && std::filesystem::path(output).has_parent_path())
+            std::filesystem::create_directories(std::filesystem::path(output).parent_path());
+        StreamingConverter converter(args.back(), output, memory_mb * 1024 * 1024);
+        converter.convert();
+        if (use_cache)
+            cache.evict(output);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::cout << "Converted " << std::to_string(converter.num_vertices) << " vertices and " << std::to_string(converter.num_edges)
+                  << " edges to " << output << " (" << std::to_string(converter.num_runs) << " runs) in "
+                  << std::to_string(long(std::chrono::duration<double, std::milli>(t2 - t1).count())) << " ms." << std::endl;
+        return 0;
+    }
+
+    // The allocation policy applies to the arrays allocated from now on, so it is set before parsing
+    auto pages = pages_arg != args.end() ? AllocationPolicy::parse_pages(pages_arg->substr(std::string("--pages=").size())) : AllocationPolicy::DEFAULT_PAGES;
+    auto numa = numa_arg != args.end() ? AllocationPolicy::parse_numa(numa_arg->substr(std::string("--numa=").size())) : AllocationPolicy::NUMA_DEFAULT;
+    AllocationPolicy::global().configure(pages, numa, std::max(1u, std::thread::hardware_concurrency()));
+
+    ParserOptions parser_options;
+    parser_options.verify_fast = verify_fast;
+    parser_options.use_cache = std::find(args.begin(), args.end(), "--no-cache") == args.end();
+    if (cache_dir_arg != args.end())
+        parser_options.cache_directory = cache_dir_arg->substr(std::string("--cache-dir=").size());
+    if (cache_limit_arg != args.end())
+        parser_options.cache_size_limit = std::stoull(cache_limit_arg->substr(std::string("--cache-limit=").size())) * 1024 * 1024;
+    parser_options.direct_io = std::find(args.begin(), args.end(), "--direct-io") != args.end();
+    parser_options.sanitize = sanitize_arg != args.end();
+    parser_options.enforce_symmetry = sanitize_arg == args.end() || *sanitize_arg == "--sanitize";
+    Parser p(args.back(), parser_options);
     Graph graph = p.parse();
     if (use_csv) {
         if (parse_only) {
@@ -21,16 +79,94 @@ int main(int argc, char **argv) {
                       << std::to_string(long(p.milliseconds)) << std::endl;
         }
     } else {
-        std::cout << "Parsed in " << std::to_string(long(p.milliseconds)) << " ms." << std::endl;
+        std::cout << "Parsed in " << std::to_string(long(p.milliseconds)) << " ms";
+        // Throughput of text parsing, to compare with the bandwidth of the device in cold-cache runs
+        if (p.text_throughput != 0) {
+            std::cout << " (" << std::to_string(long(p.text_throughput)) << " MB/s";
+            if (p.read_throughput != 0)
+                std::cout << ", read at " << std::to_string(long(p.read_throughput)) << " MB/s";
+            std::cout << ")";
+        }
+        std::cout << "." << std::endl;
+        if (p.sanitize_report) {
+            const Sanitizer::report_t &report = *p.sanitize_report;
+            if (report.skipped)
+                std::cout << "Skipped sanitizing: the .fast file is already clean." << std::endl;
+            else
+                std::cout << "Sanitized in " << std::to_string(long(report.milliseconds)) << " ms: removed "
+                          << std::to_string(report.self_loops) << " self-loops, " << std::to_string(report.duplicates)
+                          << " duplicate neighbors and " << std::to_string(report.out_of_range) << " out-of-range neighbors, sorted " << std::to_string(report.unsorted_rows) << " rows; "
+                          << std::to_string(report.asymmetric_edges) << " asymmetric edges "
+                          << (parser_options.enforce_symmetry ? "fixed" : "kept") << "." << std::endl;
+        }
     }
     if (parse_only)
         return 0;
 
-    Benchmark bench(graph);
+    std::string ordering = "none";
+    // Kept to map colorings between the original and the reordered IDs
+    std::unique_ptr<Reordering> reordering;
+    if (reorder_arg != args.end()) {
+        auto strategy = Reordering::parse_strategy(reorder_arg->substr(std::string("--reorder=").size()));
+        ordering = Reordering::strategy_name(strategy);
+        // Relabel the vertices for locality; the solvers then work on the reordered graph
+        auto t1 = std::chrono::high_resolution_clock::now();
+        reordering = std::make_unique<Reordering>(graph, strategy, std::thread::hardware_concurrency());
+        graph = reordering->apply(graph);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        if (!use_csv)
+            std::cout << "Reordered (" << ordering << ") in " << std::to_string(long(std::chrono::duration<double, std::milli>(t2 - t1).count())) << " ms." << std::endl;
+    }
+
+    // The previous coloring uses the original IDs
+    std::unique_ptr<Coloring> warm_start;
+    if (warm_start_arg != args.end()) {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        warm_start = std::make_unique<Coloring>(ColoringFile::read(warm_start_arg->substr(std::string("--warm-start=").size()), graph.num_vertices(), std::max(1u, std::thread::hardware_concurrency())));
+        if (reordering)
+            warm_start = std::make_unique<Coloring>(reordering->relabel(*warm_start));
+        auto t2 = std::chrono::high_resolution_clock::now();
+        if (!use_csv)
+            std::cout << "Read the initial coloring in " << std::to_string(long(std::chrono::duration<double, std::milli>(t2 - t1).count())) << " ms." << std::endl;
+    }
+
+    std::unique_ptr<CompressedGraph> compressed;
+    if (use_compressed) {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        compressed = std::make_unique<CompressedGraph>(graph, std::thread::hardware_concurrency());
+        auto t2 = std::chrono::high_resolution_clock::now();
+        if (!use_csv)
+            std::cout << "Compressed " << std::to_string(uint64_t(graph.num_edges()) * sizeof(vertex_t) / 1024) << " KB of adjacency lists to "
+                      << std::to_string(uint64_t(compressed->num_bytes()) / 1024) << " KB in "
+                      << std::to_string(long(std::chrono::duration<double, std::milli>(t2 - t1).count())) << " ms." << std::endl;
+        // Release the uncompressed adjacency lists, so that only the compressed ones are in memory while solving
+        graph = Graph(policy_vector<offset_t>(1, 0), {});
+    }
+
+    Benchmark bench = compressed ? Benchmark(*compressed) : Benchmark(graph);
+    bench.settings.ordering = ordering;
+    bench.settings.keep_best = colors_arg != args.end();
+    bench.settings.warm_start = warm_start.get();
     if (use_csv) {
         bench.settings.output = bench.settings.USE_CSV;
         bench.settings.parse_md = &p.metadata;
     }
     bench.run();
+
+    if (colors_arg != args.end()) {
+        if (!bench.best_coloring()) {
+            std::cerr << "No valid coloring to write." << std::endl;
+            return 1;
+        }
+        std::string colors_path = colors_arg->substr(std::string("--colors=").size());
+        auto t1 = std::chrono::high_resolution_clock::now();
+        if (reordering)
+            ColoringFile::write(reordering->restore(*bench.best_coloring()), colors_path, std::max(1u, std::thread::hardware_concurrency()));
+        else
+            ColoringFile::write(*bench.best_coloring(), colors_path, std::max(1u, std::thread::hardware_concurrency()));
+        auto t2 = std::chrono::high_resolution_clock::now();
+        if (!use_csv)
+            std::cout << "Wrote the best coloring to " << colors_path << " in " << std::to_string(long(std::chrono::duration<double, std::milli>(t2 - t1).count())) << " ms." << std::endl;
+    }
     return 0;
 }
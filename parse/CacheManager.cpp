@@ -0,0 +1,94 @@
+#include "CacheManager.h"
+#include "../utils/MappedFile.h"
+#include "FastFormat.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Length of the hexadecimal key in entry names
+static const size_t KEY_DIGITS = 16;
+
+static uint64_t combine(uint64_t seed, uint64_t value) {
+    // splitmix64 finalizer over the running key
+    uint64_t z = seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+CacheManager::CacheManager(const std::string &directory, uint64_t size_limit)
+    : directory(directory), size_limit(size_limit) {}
+
+bool CacheManager::is_entry(const std::string &filename) {
+    // <source name>.<key>.fast
+    const std::string suffix = ".fast";
+    if (filename.size() < KEY_DIGITS + 1 + suffix.size() + 1 || !filename.ends_with(suffix))
+        return false;
+    size_t key_start = filename.size() - suffix.size() - KEY_DIGITS;
+    return filename[key_start - 1] == '.' &&
+           std::all_of(filename.begin() + key_start, filename.end() - suffix.size(), [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; });
+}
+
+uint64_t CacheManager::hash_contents(const std::string &source) {
+    MappedFile file(source);
+    return fast_checksum(file.data(), file.size(), 0, std::max(1u, std::thread::hardware_concurrency()));
+}
+
+std::string CacheManager::entry_path(const std::string &source, uint64_t contents, uint64_t variant) const {
+    uint64_t size = fs::file_size(source);
+    uint64_t mtime = fs::last_write_time(source).time_since_epoch().count();
+    uint64_t key = combine(combine(combine(0, size), mtime), contents);
+    // Keep the keys of plain entries unchanged
+    if (variant != 0)
+        key = combine(key, variant);
+
+    char hex[KEY_DIGITS + 1];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key));
+    fs::path source_path(source);
+    fs::path entry_directory = directory.empty() ? source_path.parent_path() : fs::path(directory);
+    return (entry_directory / (source_path.filename().string() + "." + hex + ".fast")).string();
+}
+
+void CacheManager::touch(const std::string &entry) {
+    std::error_code ignored;
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), ignored);
+}
+
+void CacheManager::evict(const std::string &entry) const {
+    if (size_limit == 0)
+        return;
+    struct cached_t {
+        fs::path path;
+        fs::file_time_type last_used;
+        uint64_t size;
+    };
+    std::vector<cached_t> entries;
+    uint64_t total_size = 0;
+    std::error_code error;
+    fs::path entry_path(entry);
+    fs::path entry_directory = entry_path.has_parent_path() ? entry_path.parent_path() : fs::path(".");
+    for (const auto &file : fs::directory_iterator(entry_directory, error)) {
+        if (!file.is_regular_file(error) || !is_entry(file.path().filename().string()))
+            continue;
+        cached_t cached = {file.path(), file.last_write_time(error), file.file_size(error)};
+        if (error)
+            continue;
+        total_size += cached.size;
+        if (!fs::equivalent(cached.path, entry_path, error))
+            entries.push_back(cached);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const cached_t &a, const cached_t &b) { return a.last_used < b.last_used; });
+    for (const auto &cached : entries) {
+        if (total_size <= size_limit)
+            break;
+        // Another process may have removed it already
+        if (fs::remove(cached.path, error))
+            total_size -= cached.size;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef GRAPH_COLORING_CACHEMANAGER_H
+#define GRAPH_COLORING_CACHEMANAGER_H
+
+#include <cstdint>
+#include <string>
+
+/* CacheManager names and evicts the .fast caches of text graphs.
+ *
+ * A cache entry is named after the source file and a key derived from its size, modification time and a hash of its
+ * contents (eg. "road.gra.0123456789abcdef.fast"), so that an edited source never matches the entry of its previous
+ * contents, even if its size and modification time were preserved. Entries are stored in a configurable directory
+ * (by default that of the source), which can thus be on faster storage than the inputs.
+ *
+ * The modification time of an entry records when it was last used. When the entries in the directory exceed the size
+ * limit, the least recently used ones are removed.
+ */
+class CacheManager {
+    std::string directory;
+    uint64_t size_limit;
+
+    // Whether a file name is that of a cache entry
+    static bool is_entry(const std::string &filename);
+
+  public:
+    // An empty directory stores each entry next to its source; a size limit of 0 means no limit
+    CacheManager(const std::string &directory, uint64_t size_limit);
+
+    // Hash of the contents of source, which reads it in full (in parallel): the fast_checksum of the whole file
+    static uint64_t hash_contents(const std::string &source);
+    // Path of the cache entry for source, given the hash of its current contents, which may not exist yet. Graphs
+    // derived differently from the same source (eg. sanitized) are stored under another nonzero variant.
+    std::string entry_path(const std::string &source, uint64_t contents, uint64_t variant = 0) const;
+    // Mark an existing entry as the most recently used
+    static void touch(const std::string &entry);
+    // Remove the least recently used entries in the directory of `entry` until their total size fits the limit. The
+    // given entry, which was just written or used, is kept.
+    void evict(const std::string &entry) const;
+};
+
+#endif //GRAPH_COLORING_CACHEMANAGER_H
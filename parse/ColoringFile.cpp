@@ -0,0 +1,206 @@
+#include "ColoringFile.h"
+#include "../utils/MappedFile.h"
+#include "../utils/RangeSplitter.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+// Vertices per buffer when writing binary files
+static const uint64_t BINARY_CHUNK = 1 << 16;
+
+// Write size bytes at offset, retrying partial writes; return false on error
+static bool write_at(int fd, const char *data, size_t size, uint64_t offset) {
+    while (size != 0) {
+        ssize_t written = pwrite(fd, data, size, offset);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        data += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
+
+ColoringFile::format_t ColoringFile::format_of(const std::string &path) {
+    auto extension = std::filesystem::path(path).extension();
+    if (extension == ".u32")
+        return U32;
+    if (extension == ".u16")
+        return U16;
+    return TEXT;
+}
+
+template <typename T>
+static bool write_binary(const Coloring &coloring, int fd, int num_threads, color_t &too_large) {
+    // Errors are reported once all threads are done, since an exception cannot cross a thread boundary
+    std::atomic<bool> failed = false, overflow = false;
+    parallel_for(coloring.num_vertices(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        std::vector<T> buffer;
+        for (uint64_t first = from; first < to && !failed; first += BINARY_CHUNK) {
+            uint64_t last = std::min(to, first + BINARY_CHUNK);
+            buffer.resize(last - first);
+            for (uint64_t vertex = first; vertex < last; vertex++) {
+                color_t color = coloring.color_of(vertex);
+                if (color > std::numeric_limits<T>::max() && !overflow.exchange(true))
+                    too_large = color;
+                buffer[vertex - first] = T(color);
+            }
+            if (!write_at(fd, reinterpret_cast<const char *>(buffer.data()), buffer.size() * sizeof(T), first * sizeof(T)))
+                failed = true;
+        }
+    });
+    if (overflow)
+        throw std::runtime_error("Color " + std::to_string(too_large) + " does not fit in a 16-bit coloring file");
+    return !failed;
+}
+
+static bool write_text(const Coloring &coloring, int fd, int num_threads) {
+    std::vector<std::string> buffers(num_threads);
+    parallel_for(coloring.num_vertices(), num_threads, [&](int thread_idx, uint64_t from, uint64_t to) {
+        std::string &buffer = buffers[thread_idx];
+        char digits[std::numeric_limits<color_t>::digits10 + 2];
+        for (uint64_t vertex = from; vertex < to; vertex++) {
+            char *end = std::to_chars(digits, digits + sizeof(digits), coloring.color_of(vertex)).ptr;
+            *end++ = '\n';
+            buffer.append(digits, end);
+        }
+    });
+    // Each range starts where the previous ones end
+    std::vector<uint64_t> offsets(num_threads + 1, 0);
+    for (int thread_idx = 0; thread_idx < num_threads; thread_idx++)
+        offsets[thread_idx + 1] = offsets[thread_idx] + buffers[thread_idx].size();
+    std::atomic<bool> failed = false;
+    parallel_for(num_threads, num_threads, [&](int thread_idx, uint64_t, uint64_t) {
+        if (!write_at(fd, buffers[thread_idx].data(), buffers[thread_idx].size(), offsets[thread_idx]))
+            failed = true;
+    });
+    return !failed;
+}
+
+void ColoringFile::write(const Coloring &coloring, const std::string &path, int num_threads) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+        throw std::runtime_error("Failed to open " + path + " for writing");
+    bool written;
+    color_t too_large = 0;
+    try {
+        switch (format_of(path)) {
+        case U32:
+            written = write_binary<uint32_t>(coloring, fd, num_threads, too_large);
+            break;
+        case U16:
+            written = write_binary<uint16_t>(coloring, fd, num_threads, too_large);
+            break;
+        default:
+            written = write_text(coloring, fd, num_threads);
+        }
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    if (close(fd) != 0 || !written)
+        throw std::runtime_error("Failed to write " + path);
+}
+
+// Colors are below the number of vertices in any first-fit coloring, so a larger one means that the file is not a
+// coloring of this graph; the first such color is reported
+static void check_colors(const std::atomic<bool> &too_large, uint64_t vertex, uint64_t color, vertex_t num_vertices) {
+    if (too_large)
+        throw std::runtime_error("Color " + std::to_string(color) + " of vertex " + std::to_string(vertex) +
+                                 " in coloring file is not below the number of vertices (" + std::to_string(num_vertices) + ")");
+}
+
+template <typename T>
+static void read_binary(const MappedFile &file, Coloring &coloring, int num_threads) {
+    if (file.size() % sizeof(T) != 0)
+        throw std::runtime_error("Truncated coloring file");
+    uint64_t num_colors = std::min<uint64_t>(file.size() / sizeof(T), coloring.num_vertices());
+    std::atomic<bool> too_large = false;
+    uint64_t bad_vertex = 0, bad_color = 0;
+    parallel_for(num_colors, num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (uint64_t vertex = from; vertex < to; vertex++) {
+            T color;
+            std::memcpy(&color, file.data() + vertex * sizeof(T), sizeof(T));
+            if (uint64_t(color) >= coloring.num_vertices() && !too_large.exchange(true)) {
+                bad_vertex = vertex;
+                bad_color = color;
+            }
+            coloring.set_color(vertex, color);
+        }
+    });
+    check_colors(too_large, bad_vertex, bad_color, coloring.num_vertices());
+    parallel_for(coloring.num_vertices() - num_colors, num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (uint64_t vertex = num_colors + from; vertex < num_colors + to; vertex++)
+            coloring.set_color(vertex, Coloring::UNCOLORED);
+    });
+}
+
+static void read_text(const MappedFile &file, Coloring &coloring, int num_threads) {
+    const char *begin = reinterpret_cast<const char *>(file.data()), *end = begin + file.size();
+    std::vector<const char *> boundaries = Tokenizer::split_lines(begin, end, num_threads);
+    // Line numbers are vertex IDs, so each range needs the number of lines before it
+    std::vector<uint64_t> first_lines(num_threads + 1, 0);
+    parallel_for(num_threads, num_threads, [&](int chunk, uint64_t, uint64_t) {
+        const char *from = boundaries[chunk], *to = boundaries[chunk + 1];
+        uint64_t lines = std::count(from, to, '\n');
+        first_lines[chunk + 1] = lines + (from != to && to[-1] != '\n');
+    });
+    for (int chunk = 0; chunk < num_threads; chunk++)
+        first_lines[chunk + 1] += first_lines[chunk];
+
+    std::atomic<bool> invalid = false, too_large = false;
+    uint64_t bad_vertex = 0, bad_color = 0;
+    parallel_for(num_threads, num_threads, [&](int chunk, uint64_t, uint64_t) {
+        uint64_t vertex = first_lines[chunk];
+        Tokenizer::for_each_line(boundaries[chunk], boundaries[chunk + 1], [&](std::string_view line) {
+            const char *line_end = line.data() + line.size();
+            uint64_t color;
+            const char *pos = Tokenizer::parse_uint(Tokenizer::skip_separators(line.data(), line_end), line_end, color);
+            if (pos == nullptr || Tokenizer::skip_separators(pos, line_end) != line_end) {
+                invalid.store(true, std::memory_order_relaxed);
+            } else if (vertex < coloring.num_vertices()) {
+                if (color >= coloring.num_vertices() && !too_large.exchange(true)) {
+                    bad_vertex = vertex;
+                    bad_color = color;
+                }
+                coloring.set_color(vertex, color_t(color));
+            }
+            vertex++;
+        });
+    });
+    if (invalid)
+        throw std::runtime_error("Malformed color in coloring file");
+    check_colors(too_large, bad_vertex, bad_color, coloring.num_vertices());
+
+    uint64_t num_colors = std::min<uint64_t>(first_lines[num_threads], coloring.num_vertices());
+    parallel_for(coloring.num_vertices() - num_colors, num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (uint64_t vertex = num_colors + from; vertex < num_colors + to; vertex++)
+            coloring.set_color(vertex, Coloring::UNCOLORED);
+    });
+}
+
+Coloring ColoringFile::read(const std::string &path, vertex_t num_vertices, int num_threads) {
+    MappedFile file(path);
+    Coloring coloring(num_vertices);
+    switch (format_of(path)) {
+    case U32:
+        read_binary<uint32_t>(file, coloring, num_threads);
+        break;
+    case U16:
+        read_binary<uint16_t>(file, coloring, num_threads);
+        break;
+    default:
+        read_text(file, coloring, num_threads);
+    }
+    return coloring;
+}
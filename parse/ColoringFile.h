@@ -0,0 +1,34 @@
+#ifndef GRAPH_COLORING_COLORINGFILE_H
+#define GRAPH_COLORING_COLORINGFILE_H
+
+#include "../graph/Coloring.h"
+#include <string>
+
+/* ColoringFile writes colorings to disk and reads them back, eg. to warm-start a solver (see WarmStartSolver).
+ *
+ * The format is chosen by extension: .u32 and .u16 files are the raw array of colors, one 32-bit or 16-bit integer per
+ * vertex in the byte order of the machine, so that they can be mapped and indexed directly; any other file is text,
+ * with the color of vertex i on line i (counting from 0).
+ *
+ * Both directions run in parallel. Each thread formats a range of vertices into its own buffer and writes it at its
+ * offset with pwrite (text ranges are measured first, and their offsets computed with a prefix sum); reading splits
+ * the mapped file into ranges of lines, or of integers, the same way.
+ */
+class ColoringFile {
+  public:
+    enum format_t { TEXT,
+                    U32,
+                    U16 };
+
+    // The format of a file, by extension
+    static format_t format_of(const std::string &path);
+
+    // Throws if a color does not fit in the format
+    static void write(const Coloring &, const std::string &path, int num_threads = 1);
+    // Read the coloring of a graph with num_vertices vertices: vertices past the end of the file are UNCOLORED, and
+    // colors past num_vertices are ignored, so that a coloring of a slightly different graph can be reused. Throws on
+    // a color that is not below num_vertices, which no first-fit coloring uses.
+    static Coloring read(const std::string &path, vertex_t num_vertices, int num_threads = 1);
+};
+
+#endif //GRAPH_COLORING_COLORINGFILE_H
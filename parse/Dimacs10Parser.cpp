@@ -1,62 +1,230 @@
 #include "Dimacs10Parser.h"
+#include "../utils/MappedFile.h"
+#include "../utils/RangeSplitter.h"
 #include "Parser.h"
+#include "Tokenizer.h"
 #include <algorithm>
-#include <sstream>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <thread>
 
-Dimacs10Parser::Dimacs10Parser(std::ifstream &_file, const std::string &filename)
-    : file(std::move(_file)), fastparse_file(filename + ".fast") {
-    if (!fastparse_file.is_open())
-        throw std::runtime_error("Failed to open fastparse file for writing!");
-}
+Dimacs10Parser::Dimacs10Parser(const std::string &filename, bool direct_io)
+    : filename(filename), num_threads(std::max(1u, std::thread::hardware_concurrency())), direct_io(direct_io) {}
 
-// We do not need to worry about large copies: the compiler will move() the vector because of RVO
 Graph Dimacs10Parser::parse() {
-    std::string header;
-    std::getline(file, header);
-    uint32_t numVertices;
-
-    std::vector<uint32_t> header_vals = parse_numbers(header, true);
-    switch (header_vals.size()) {
-    case 2:
-        numVertices = header_vals[0];
-        // numEdges = header_vals[1];
-        break;
-    default:
-        throw std::runtime_error("Unexpected header size");
+    if (TextStream::is_streamed(filename, direct_io)) {
+        TextStream stream(filename);
+        std::string &first = stream.first_block();
+        const char *body = first.data();
+        format_t format = parse_header(body, first.data() + first.size());
+        first.erase(0, body - first.data());
+        Graph g = symmetrize(parse_stream(stream, format));
+        stats = stream.stats();
+        return g;
     }
 
-    queue.onReceive(
-        4, (void (*)(message_t))[](message_t message) {
-            // Parse the line and put it into the iterator
-            // Note that no locking is required: we always access different positions in the vector
-            *message.second = parse_numbers(message.first);
+    MappedFile file(filename);
+    const char *body = reinterpret_cast<const char *>(file.data()), *end = body + file.size();
+    stats.text_bytes = file.size();
+    format_t format = parse_header(body, end);
+    uint64_t num_vertices = format.num_vertices;
+
+    // Split the body in byte ranges, moving each boundary to the start of the following line
+    std::vector<const char *> boundaries = Tokenizer::split_lines(body, end, num_threads);
+
+    // First pass: count the lines of each range and the neighbors on each line
+    std::vector<std::vector<vertex_t>> degrees(num_threads);
+    parallel_for(num_threads, num_threads, [&](int chunk, uint64_t, uint64_t) {
+        Tokenizer::for_each_line(boundaries[chunk], boundaries[chunk + 1], [&](std::string_view line) {
+            if (!is_comment(line))
+                degrees[chunk].push_back(count_numbers(line, format));
+        });
+    });
+
+    // The ID of the first vertex of each range is the number of lines before it; lines after the last vertex are
+    // ignored, and missing lines are isolated vertices
+    std::vector<uint64_t> first_ids(num_threads + 1, 0);
+    for (int chunk = 0; chunk < num_threads; chunk++)
+        first_ids[chunk + 1] = first_ids[chunk] + degrees[chunk].size();
+
+    GraphBuilder builder(num_vertices);
+    parallel_for(num_threads, num_threads, [&](int chunk, uint64_t, uint64_t) {
+        for (uint64_t idx = 0; idx < degrees[chunk].size() && first_ids[chunk] + idx < num_vertices; idx++)
+            builder.set_degree(first_ids[chunk] + idx, degrees[chunk][idx]);
+        degrees[chunk] = {};
+    });
+    builder.compute_offsets();
+
+    // Second pass: parse each line directly into its slot in the neighbor array. Errors are reported once all threads
+    // are done, since an exception cannot cross a thread boundary
+    std::atomic<bool> invalid = false;
+    parallel_for(num_threads, num_threads, [&](int chunk, uint64_t, uint64_t) {
+        uint64_t vertex = first_ids[chunk];
+        Tokenizer::for_each_line(boundaries[chunk], boundaries[chunk + 1], [&](std::string_view line) {
+            if (is_comment(line))
+                return;
+            // Note that no locking is required: we always access different positions in the array
+            if (vertex < num_vertices && !parse_numbers(line, builder.neighbors_of(vertex), format))
+                invalid.store(true, std::memory_order_relaxed);
+            vertex++;
+        });
+    });
+    if (invalid)
+        throw std::runtime_error("Malformed line or invalid vertex ID in DIMACS-10 file");
+
+    return symmetrize(builder.build());
+}
+
+Graph Dimacs10Parser::parse_stream(TextStream &stream, const format_t &format) {
+    uint64_t num_vertices = format.num_vertices;
+    struct parsed_block_t {
+        // Position of the block in the file, and ID of its first vertex
+        uint64_t index, first_vertex = 0;
+        std::vector<vertex_t> degrees;
+        adjacency_vec_t neighbors;
+    };
+    std::vector<parsed_block_t> blocks;
+    std::mutex blocks_mutex;
+    std::atomic<bool> invalid = false;
+    // Comments are not rows, so the first vertex of a block is not known from its first line: each block parses all of
+    // its rows, and they are numbered once all blocks are parsed
+    stream.for_each_block(num_threads, [&](const TextStream::block_t &block) {
+        parsed_block_t parsed = {block.index};
+        Tokenizer::for_each_line(block.text.data(), block.text.data() + block.text.size(), [&](std::string_view line) {
+            if (is_comment(line))
+                return;
+            vertex_t degree = count_numbers(line, format);
+            parsed.degrees.push_back(degree);
+            size_t start = parsed.neighbors.size();
+            parsed.neighbors.resize(start + degree);
+            if (!parse_numbers(line, nonstd::span<vertex_t>(parsed.neighbors.data() + start, degree), format))
+                invalid.store(true, std::memory_order_relaxed);
         });
+        std::lock_guard<std::mutex> lock(blocks_mutex);
+        blocks.push_back(std::move(parsed));
+    });
+    if (invalid)
+        throw std::runtime_error("Malformed line or invalid vertex ID in DIMACS-10 file");
 
-    std::vector<adjacency_vec_t> vertices(numVertices);
-    std::string line;
-    for (uint32_t i = 0; i < numVertices; i++) {
-        std::getline(file, line);
-        queue.push(std::make_pair(line, vertices.begin() + i));
+    // The ID of the first vertex of each block is the number of rows before it, as in the mapped path. Rows after the
+    // last vertex are ignored.
+    std::sort(blocks.begin(), blocks.end(), [](const parsed_block_t &a, const parsed_block_t &b) { return a.index < b.index; });
+    uint64_t next_vertex = 0;
+    for (auto &parsed : blocks) {
+        parsed.first_vertex = next_vertex;
+        next_vertex += parsed.degrees.size();
+        if (parsed.first_vertex >= num_vertices)
+            parsed.degrees.clear();
+        else if (parsed.first_vertex + parsed.degrees.size() > num_vertices)
+            parsed.degrees.resize(num_vertices - parsed.first_vertex);
     }
 
-    queue.stop();
-    queue.join();
+    // Blocks cover disjoint rows, so they are copied into the CSR arrays in parallel
+    GraphBuilder builder(num_vertices);
+    parallel_for(blocks.size(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (uint64_t idx = from; idx < to; idx++)
+            for (uint64_t row = 0; row < blocks[idx].degrees.size(); row++)
+                builder.set_degree(blocks[idx].first_vertex + row, blocks[idx].degrees[row]);
+    });
+    builder.compute_offsets();
+    parallel_for(blocks.size(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (uint64_t idx = from; idx < to; idx++) {
+            const vertex_t *source = blocks[idx].neighbors.data();
+            for (uint64_t row = 0; row < blocks[idx].degrees.size(); row++) {
+                auto neighbors = builder.neighbors_of(blocks[idx].first_vertex + row);
+                std::copy_n(source, neighbors.size(), neighbors.begin());
+                source += neighbors.size();
+            }
+            blocks[idx] = {};
+        }
+    });
+    return builder.build();
+}
+
+Graph Dimacs10Parser::symmetrize(Graph &&graph) const {
+    std::atomic<bool> duplicates = false;
+    parallel_for(graph.num_vertices(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; vertex++) {
+            auto neighbors = graph.neighbors_of(vertex);
+            // Rows were sorted by parse_numbers
+            if (std::adjacent_find(neighbors.begin(), neighbors.end()) != neighbors.end())
+                duplicates.store(true, std::memory_order_relaxed);
+        }
+    });
+    if (!duplicates && GraphBuilder::is_symmetric(graph, num_threads))
+        return std::move(graph);
+    return GraphBuilder::symmetrize(graph, num_threads);
+}
+
+Dimacs10Parser::format_t Dimacs10Parser::parse_header(const char *&pos, const char *end) {
+    std::string_view header;
+    do {
+        if (pos == end)
+            throw std::runtime_error("Unexpected header size");
+        const char *header_end = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+        header = std::string_view(pos, (header_end ? header_end : end) - pos);
+        pos = header_end ? header_end + 1 : end;
+    } while (is_comment(header));
+
+    // n m [fmt [ncon]]; the number of edges is not needed
+    std::vector<uint64_t> values;
+    const char *header_end = header.data() + header.size();
+    if (Tokenizer::parse_uints(header.data(), header_end, [&values](uint64_t value) { values.push_back(value); }) != header_end)
+        throw std::runtime_error("Malformed header");
+    if (values.size() < 2 || values.size() > 4)
+        throw std::runtime_error("Unexpected header size");
 
-    return Graph(std::move(vertices));
+    format_t format;
+    format.num_vertices = values[0];
+    if (values.size() >= 3) {
+        // fmt is up to three binary digits: vertex sizes, vertex weights and edge weights
+        uint64_t fmt = values[2];
+        bool sizes = fmt / 100, vertex_weights = fmt / 10 % 10, edge_weights = fmt % 10;
+        if (fmt > 111 || fmt / 10 % 10 > 1 || fmt % 10 > 1)
+            throw std::runtime_error("Unsupported METIS format " + std::to_string(fmt));
+        // ncon is the number of weights per vertex, 1 by default
+        uint64_t num_weights = vertex_weights ? (values.size() == 4 ? values[3] : 1) : 0;
+        format.vertex_fields = sizes + num_weights;
+        format.neighbor_fields = 1 + edge_weights;
+    }
+    if (format.num_vertices >= std::numeric_limits<vertex_t>::max())
+        throw std::runtime_error("Too many vertices for the configured vertex ID width");
+    return format;
+}
+
+vertex_t Dimacs10Parser::count_numbers(std::string_view line, const format_t &format) {
+    uint64_t tokens = Tokenizer::count_tokens(line.data(), line.data() + line.size());
+    // A line too short for the format is rejected by parse_numbers
+    return tokens < format.vertex_fields ? 0 : (tokens - format.vertex_fields) / format.neighbor_fields;
 }
 
-std::vector<uint32_t> Dimacs10Parser::parse_numbers(const std::string &line, bool is_header) {
-    std::vector<uint32_t> ret;
-    std::istringstream line_str(line);
-    std::string number_str;
-    // std::getline reads line_str up to the next space and writes it into number_str
-    while (std::getline(line_str, number_str, ' ')) {
-        uint32_t number = std::stoul(number_str);
-        if (!is_header)
-            number -= 1; // In the Metis format, vertices start from 1
-        ret.emplace_back(number);
+bool Dimacs10Parser::parse_numbers(std::string_view line, nonstd::span<vertex_t> out, const format_t &format) {
+    size_t count = 0, tokens = 0;
+    bool in_range = true;
+    const char *end = line.data() + line.size();
+    const char *rest;
+    if (format.vertex_fields == 0 && format.neighbor_fields == 1) {
+        rest = Tokenizer::parse_uints(line.data(), end, [&](uint64_t id) {
+            // In the Metis format, vertices start from 1
+            in_range &= id != 0 && id <= format.num_vertices;
+            out[count++] = id - 1;
+        });
+        tokens = count;
+    } else {
+        // Skip the vertex size and weights, and the weight after each neighbor
+        rest = Tokenizer::parse_uints(line.data(), end, [&](uint64_t value) {
+            if (tokens >= format.vertex_fields && (tokens - format.vertex_fields) % format.neighbor_fields == 0 && count < out.size()) {
+                in_range &= value != 0 && value <= format.num_vertices;
+                out[count++] = value - 1;
+            }
+            tokens++;
+        });
     }
+    if (rest != end || !in_range || tokens != format.vertex_fields + out.size() * format.neighbor_fields)
+        return false;
     // Sorted vectors allows for efficient algorithms like std::set_intersection
-    std::sort(ret.begin(), ret.end());
-    return ret;
-}
\ No newline at end of file
+    std::sort(out.begin(), out.end());
+    return true;
+}
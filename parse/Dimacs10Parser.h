@@ -2,26 +2,63 @@
 #define GRAPH_COLORING_DIMACS10PARSER_H
 
 #include "../graph/Graph.h"
-#include "../utils/PCVector.h"
+#include "../graph/GraphBuilder.h"
 #include "Parser.h"
-#include <fstream>
-#include <thread>
+#include "TextStream.h"
+#include <string>
+#include <string_view>
 #include <vector>
 
+/* Dimacs10Parser reads the DIMACS-10 (Metis) format, where the i-th line after the header lists the neighbors of
+ * vertex i. Lines beginning with % are comments. The optional fmt field of the header says whether each line begins
+ * with a vertex size and vertex weights, and whether each neighbor is followed by an edge weight; weights are parsed
+ * and skipped, since colorings do not depend on them.
+ *
+ * The file is mapped and split into one byte range per thread, with boundaries moved forward to the next line start.
+ * Each thread counts the lines (and the neighbors on each line) of its range; a prefix sum over the line counts then
+ * gives the ID of the first vertex of each range, and the threads parse their lines directly into the neighbor array.
+ *
+ * Compressed files (and uncompressed ones, with direct I/O) are parsed block by block as they are read (see
+ * TextStream): each block is parsed into its own degree and neighbor arrays, which are copied into the CSR arrays once
+ * all of them are known.
+ *
+ * METIS files should list each edge in the rows of both endpoints, once. This is checked in a parallel pass over the
+ * rows (duplicates are adjacent, since rows are sorted, and symmetry is checked with the same sum of edge hashes as
+ * the SYMMETRIC flag of .fast files); if it does not hold, the rows are rebuilt with GraphBuilder::symmetrize, which
+ * adds the missing reverse edges and removes the duplicates, as for the other text formats.
+ */
 class Dimacs10Parser : public IParser {
-    std::ifstream file;
-    std::ofstream fastparse_file;
+    std::string filename;
+    int num_threads;
+    // Stream uncompressed files too, reading them with direct I/O instead of mapping them
+    bool direct_io;
 
-    using position_t = std::vector<adjacency_vec_t>::iterator;
-    // Store the string to be parsed and the position where to put it
-    using message_t = std::pair<std::string, position_t>;
-    PCVector<message_t> queue;
+  public:
+    // What the header says about the lines that follow it
+    struct format_t {
+        uint64_t num_vertices = 0;
+        // Numbers at the start of each line, before the neighbors (vertex size and weights)
+        unsigned vertex_fields = 0;
+        // Numbers per neighbor: 1, or 2 if each is followed by an edge weight
+        unsigned neighbor_fields = 1;
+    };
 
-    // Parse a line into a vector of numbers
-    static std::vector<uint32_t> parse_numbers(const std::string &line, bool is_header = false);
+  private:
+    Graph parse_stream(TextStream &stream, const format_t &format);
+    // Return the graph as is if it is symmetric and has no duplicate neighbors, and a symmetrized copy otherwise
+    Graph symmetrize(Graph &&graph) const;
 
   public:
-    Dimacs10Parser(std::ifstream &, const std::string &filename);
+    Dimacs10Parser(const std::string &filename, bool direct_io = false);
+
+    // Parse the header at pos (after any comments); pos is moved to the first adjacency list
+    static format_t parse_header(const char *&pos, const char *end);
+    static bool is_comment(std::string_view line) { return !line.empty() && line[0] == '%'; }
+    // Count the neighbors on a line, i.e. the degree of the vertex it describes
+    static vertex_t count_numbers(std::string_view line, const format_t &format);
+    // Parse a line of neighbor IDs into the given slot; return false if an ID is malformed or out of range, or if the
+    // line does not match the format
+    static bool parse_numbers(std::string_view line, nonstd::span<vertex_t> out, const format_t &format);
 
     Graph parse();
 };
@@ -1,111 +1,149 @@
 #include "DimacsParser.h"
-#include "../utils/PCVector.h"
+#include "../graph/GraphBuilder.h"
+#include "../utils/MappedFile.h"
 #include "../utils/RangeSplitter.h"
 #include "Parser.h"
+#include "Tokenizer.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
-#include <sstream>
+#include <cstring>
+#include <limits>
+#include <mutex>
 #include <thread>
 
-DimacsParser::DimacsParser(std::ifstream &_file, const std::string &filename)
-    : file(std::move(_file)), fastparse_file(filename + ".fast"), num_threads(2) {
-    if (!fastparse_file.is_open())
-        throw std::runtime_error("Failed to open fastparse file for writing!");
-}
+DimacsParser::DimacsParser(const std::string &filename, bool direct_io)
+    : filename(filename), num_threads(std::max(1u, std::thread::hardware_concurrency())), direct_io(direct_io) {}
 
 Graph DimacsParser::parse() {
-    std::string header;
-    std::getline(file, header);
-    // Some files begin with this string for some reason; read the next line if so
-    if (header == "graph_for_greach")
-        std::getline(file, header);
-    num_vertices = std::stoul(header);
+    if (TextStream::is_streamed(filename, direct_io)) {
+        TextStream stream(filename);
+        std::string &first = stream.first_block();
+        const char *pos = first.data();
+        num_vertices = parse_header(pos, first.data() + first.size());
+        first.erase(0, pos - first.data());
+        std::vector<parsed_range_t> ranges = parse_stream(stream);
+        stats = stream.stats();
+        return merge_ranges(ranges);
+    }
 
-    // Contains the adjacency lists parsed from the file
-    std::vector<adjacency_vec_t> vertices = parse_lines();
-    // A new vector where to merge vertices, so as not to risk creating the same edges twice
-    std::vector<adjacency_vec_t> merged_vertices = merge_adj_lists(vertices);
+    MappedFile file(filename);
+    const char *pos = reinterpret_cast<const char *>(file.data()), *end = pos + file.size();
+    stats.text_bytes = file.size();
+    num_vertices = parse_header(pos, end);
 
-    return Graph(merged_vertices);
+    // Contains the adjacency lists parsed from the file
+    std::vector<parsed_range_t> ranges = parse_lines(pos, end);
+    // Merge them directly into the CSR arrays, so as not to risk creating the same edges twice
+    return merge_ranges(ranges);
 }
 
-std::vector<uint32_t> DimacsParser::parse_numbers(const std::string &line) {
-    std::vector<uint32_t> ret;
+uint64_t DimacsParser::parse_header(const char *&pos, const char *end) {
+    auto next_line = [&pos, end]() {
+        auto newline = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+        std::string_view line(pos, (newline ? newline : end) - pos);
+        pos = newline ? newline + 1 : end;
+        return line;
+    };
+    std::string_view header = pos != end ? next_line() : std::string_view();
+    // Some files begin with this string for some reason; read the next line if so
+    if (header.substr(0, header.find_last_not_of('\r') + 1) == "graph_for_greach")
+        header = next_line();
+    uint64_t header_vertices;
+    const char *first = Tokenizer::skip_separators(header.data(), header.data() + header.size());
+    if (Tokenizer::parse_uint(first, header.data() + header.size(), header_vertices) == nullptr)
+        throw std::runtime_error("Malformed header");
+    if (header_vertices >= std::numeric_limits<vertex_t>::max())
+        throw std::runtime_error("Too many vertices for the configured vertex ID width");
+    return header_vertices;
+}
 
-    std::istringstream line_str(line);
-    std::string number_str;
-    // std::getline reads line_str up to the next space and writes it into number_str
+bool DimacsParser::parse_numbers(std::string_view line, adjacency_vec_t &out, vertex_t num_vertices) {
+    const char *pos = line.data(), *end = line.data() + line.size();
     // Skip the first token (containing the sequential node ID)
-    std::getline(line_str, number_str, ' ');
-    while (std::getline(line_str, number_str, ' ')) {
-        if (number_str == "#")
-            break;
-        uint32_t number = std::stoul(number_str);
-        ret.emplace_back(number);
-    }
-    return ret;
+    pos = Tokenizer::skip_token(Tokenizer::skip_separators(pos, end), end);
+    bool in_range = true;
+    // Make room for the line, keeping the growth of out geometric when it holds several lines
+    size_t needed = out.size() + Tokenizer::count_tokens(pos, end);
+    if (needed > out.capacity())
+        out.reserve(std::max(needed, 2 * out.capacity()));
+    const char *rest = Tokenizer::parse_uints(pos, end, [&](uint64_t id) {
+        in_range &= id < num_vertices;
+        out.push_back(id);
+    });
+    // Lists end with a # (which may be missing on the last line)
+    return in_range && (rest == end || *rest == '#');
 }
 
-std::vector<adjacency_vec_t> DimacsParser::parse_lines() {
-    // Contains the adjacency lists parsed from the file
-    std::vector<adjacency_vec_t> vertices(num_vertices);
+std::vector<DimacsParser::parsed_range_t> DimacsParser::parse_lines(const char *begin, const char *end) {
+    // The i-th line holds the neighbors of vertex i, so the lines are split in chunks like in Dimacs10Parser: the
+    // vertex ID of the first line in each chunk is found with a prefix sum over the line counts
+    int num_chunks = num_threads;
+    std::vector<const char *> boundaries = Tokenizer::split_lines(begin, end, num_chunks);
+    std::vector<uint64_t> first_ids(num_chunks + 1, 0);
+    parallel_for(num_chunks, num_chunks, [&](int chunk, uint64_t, uint64_t) {
+        Tokenizer::for_each_line(boundaries[chunk], boundaries[chunk + 1], [&](std::string_view) { first_ids[chunk + 1]++; });
+    });
+    for (int chunk = 0; chunk < num_chunks; chunk++)
+        first_ids[chunk + 1] += first_ids[chunk];
 
-    // Empirically, the single-thread version performs better by ~30%.
-    if (num_threads == 1) {
-        std::string line;
-        for (uint32_t i = 0; i < num_vertices; i++) {
-            std::getline(file, line);
-            vertices[i] = parse_numbers(line);
-        }
-    } else {
-        using index_line_t = std::pair<std::vector<adjacency_vec_t>::iterator, std::string>;
-        PCVector<index_line_t> line_queue;
-        line_queue.onReceive(
-            num_threads, (void (*)(index_line_t))[](index_line_t pair) {
-                *pair.first = parse_numbers(pair.second);
-            });
-        std::string line;
-        for (uint32_t i = 0; i < num_vertices; i++) {
-            std::getline(file, line);
-            line_queue.push(std::make_pair(vertices.begin() + i, line));
-        }
-        line_queue.stop();
-        line_queue.join();
-    }
-    return vertices;
+    // Each chunk is parsed into its own range. Errors are reported once all lines are parsed, since an exception
+    // cannot cross a thread boundary.
+    std::vector<parsed_range_t> ranges(num_chunks);
+    std::atomic<bool> invalid = false;
+    parallel_for(num_chunks, num_chunks, [&](int chunk, uint64_t, uint64_t) {
+        ranges[chunk].first_vertex = first_ids[chunk];
+        if (!parse_range(boundaries[chunk], boundaries[chunk + 1], ranges[chunk]))
+            invalid.store(true, std::memory_order_relaxed);
+    });
+    if (invalid)
+        throw std::runtime_error("Invalid vertex ID in DIMACS file");
+    return ranges;
 }
 
-std::vector<adjacency_vec_t> DimacsParser::merge_adj_lists(const std::vector<adjacency_vec_t> &vertices) {
-    std::vector<adjacency_vec_t> merged_vertices(vertices);
-
-    // Because DIMACS-10 only includes edges once (eg. 1->2 and not 2->1), we must merge the adjacency lists.
-    // To do so in parallel, each thread can only write to a range of 1/N elements.
-    // Each thread will iterate over all vertices and merge any relevant nodes.
-    RangeSplitter rs(num_vertices, num_threads);
-    std::vector<std::thread> threads;
-    for (int thread_idx = 0; thread_idx < num_threads; thread_idx++)
-        threads.emplace_back([&, thread_idx, rs]() {
-            // Range of lines that this thread is allowed to write: [range_lower, range_higher)
-            int range_lower = rs.get_min(thread_idx),
-                range_higher = rs.get_max(thread_idx);
-
-            // If the edge 1->2 appears, we must create 2->1: vertices[destination].push_back(source).
-            for (int source_id = 0; source_id < vertices.size(); source_id++) {
-                auto &neighbors = vertices[source_id];
-                for (uint32_t destination : neighbors)
-                    if (destination >= range_lower && destination < range_higher)
-                        merged_vertices[destination].push_back(source_id);
-            }
-
-            // Sorted vectors allow for efficient algorithms like std::set_intersection
-            for (int pos = range_lower; pos < range_higher; pos++) {
-                adjacency_vec_t &edges = merged_vertices[pos];
-                std::sort(edges.begin(), edges.end());
-            }
-        });
+std::vector<DimacsParser::parsed_range_t> DimacsParser::parse_stream(TextStream &stream) {
+    std::vector<parsed_range_t> ranges;
+    std::mutex ranges_mutex;
+    // Blocks carry the number of their first line, so they can be parsed in any order
+    std::atomic<bool> invalid = false;
+    stream.for_each_block(num_threads, [&](const TextStream::block_t &block) {
+        parsed_range_t range;
+        range.first_vertex = block.first_line;
+        if (!parse_range(block.text.data(), block.text.data() + block.text.size(), range))
+            invalid.store(true, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(ranges_mutex);
+        ranges.push_back(std::move(range));
+    });
+    if (invalid)
+        throw std::runtime_error("Invalid vertex ID in DIMACS file");
+    return ranges;
+}
 
-    for (auto &thread : threads)
-        thread.join();
+bool DimacsParser::parse_range(const char *begin, const char *end, parsed_range_t &range) const {
+    bool valid = true;
+    uint64_t vertex = range.first_vertex;
+    Tokenizer::for_each_line(begin, end, [&](std::string_view line) {
+        // Lines after the last vertex are ignored
+        if (vertex++ >= num_vertices)
+            return;
+        size_t start = range.neighbors.size();
+        valid &= parse_numbers(line, range.neighbors, num_vertices);
+        range.degrees.push_back(range.neighbors.size() - start);
+    });
+    return valid;
+}
 
-    return merged_vertices;
+Graph DimacsParser::merge_ranges(const std::vector<parsed_range_t> &ranges) {
+    // Because DIMACS only includes edges once (eg. 1->2 and not 2->1), the adjacency lists must be symmetrized. Each
+    // thread emits the edges of some of the ranges, and GraphBuilder scatters them into both endpoints' rows.
+    RangeSplitter rs(ranges.size(), num_threads);
+    return GraphBuilder::symmetrize(num_vertices, num_threads, [&](int thread_idx, auto &&emit) {
+        for (uint64_t idx = rs.get_min(thread_idx); idx < rs.get_max(thread_idx); idx++) {
+            const parsed_range_t &range = ranges[idx];
+            const vertex_t *neighbor = range.neighbors.data();
+            for (uint64_t row = 0; row < range.degrees.size(); row++)
+                for (vertex_t count = 0; count < range.degrees[row]; count++)
+                    emit(range.first_vertex + row, *neighbor++);
+        }
+    });
 }
@@ -3,25 +3,45 @@
 
 #include "../graph/Graph.h"
 #include "Parser.h"
-#include <fstream>
+#include "TextStream.h"
+#include <string>
+#include <string_view>
 #include <vector>
 
 class DimacsParser : public IParser {
-    std::ifstream file;
-    std::ofstream fastparse_file;
+    std::string filename;
     int num_threads;
-    uint32_t num_vertices;
+    bool direct_io;
+    vertex_t num_vertices;
 
-    // Parse a line into a vector of numbers
-    static std::vector<uint32_t> parse_numbers(const std::string &line);
+    // The adjacency lists on a range of consecutive lines, stored back to back rather than in one vector per vertex
+    struct parsed_range_t {
+        uint64_t first_vertex = 0;
+        std::vector<vertex_t> degrees;
+        adjacency_vec_t neighbors;
+    };
 
-    // Parse the adjacency lists, but do not merge them
-    std::vector<adjacency_vec_t> parse_lines();
-    // Merge the adjacency lists
-    std::vector<adjacency_vec_t> merge_adj_lists(const std::vector<adjacency_vec_t> &lists);
+    // Parse the lines in [begin, end), the first of which describes range.first_vertex, into range; return false if a
+    // neighbor is malformed or out of range
+    bool parse_range(const char *begin, const char *end, parsed_range_t &range) const;
+
+    // Parse the adjacency lists in [begin, end) in one range per thread, but do not merge them
+    std::vector<parsed_range_t> parse_lines(const char *begin, const char *end);
+    // Parse the adjacency lists of a compressed (or directly read) file while it is read (see TextStream), in one range
+    // per block
+    std::vector<parsed_range_t> parse_stream(TextStream &stream);
+    // Merge the adjacency lists into the CSR arrays of the graph
+    Graph merge_ranges(const std::vector<parsed_range_t> &ranges);
 
   public:
-    DimacsParser(std::ifstream &, const std::string &filename);
+    DimacsParser(const std::string &filename, bool direct_io = false);
+
+    // Parse the header at pos (skipping the optional "graph_for_greach" line) and return the number of vertices; pos
+    // is moved to the first adjacency list
+    static uint64_t parse_header(const char *&pos, const char *end);
+    // Parse the neighbors on a line (after the vertex ID, up to the final #), appending them to out; return false if a
+    // neighbor is malformed or out of range
+    static bool parse_numbers(std::string_view line, adjacency_vec_t &out, vertex_t num_vertices);
 
     Graph parse();
 };
@@ -0,0 +1,106 @@
+#ifndef GRAPH_COLORING_EDGELIST_H
+#define GRAPH_COLORING_EDGELIST_H
+
+#include "../graph/GraphBuilder.h"
+#include "../utils/MappedFile.h"
+#include "../utils/RangeSplitter.h"
+#include "TextStream.h"
+#include "Tokenizer.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* EdgeList collects the edges of the formats that list one edge per line (Matrix Market, SNAP edge lists), and builds
+ * the graph from them.
+ *
+ * Files are read like in the other text parsers: mapped and split in one chunk of lines per thread, or, if compressed
+ * (or read with direct I/O), streamed in blocks that the threads parse as they arrive (see TextStream). Each chunk
+ * collects its own edges, without synchronization; the graph is then built with GraphBuilder::symmetrize, which adds
+ * both directions of each edge and removes duplicates in parallel.
+ */
+class EdgeList {
+  public:
+    using edge_t = std::pair<vertex_t, vertex_t>;
+
+    // Edges by chunk of lines, in no particular order
+    std::vector<std::vector<edge_t>> chunks;
+    // What was read from the file
+    TextStream::stats_t stats;
+
+    // Read a file: parse_header(pos, end) reads the header at the start of the file and moves pos past it, then
+    // parse_line(line, edges) is called for each line on num_threads threads. It appends the edges of the line, and
+    // returns false if the line is malformed. Uncompressed files are mapped unless direct_io is set.
+    template <typename H, typename L>
+    static EdgeList read(const std::string &filename, int num_threads, bool direct_io, H &&parse_header, L &&parse_line);
+
+    // Parse the two numbers at the start of a line; anything after them (eg. a weight) is ignored
+    static bool parse_edge(std::string_view line, uint64_t &from, uint64_t &to) {
+        const char *end = line.data() + line.size();
+        const char *pos = Tokenizer::parse_uint(Tokenizer::skip_separators(line.data(), end), end, from);
+        if (pos == nullptr || pos == end || !Tokenizer::is_separator(*pos))
+            return false;
+        pos = Tokenizer::parse_uint(Tokenizer::skip_separators(pos, end), end, to);
+        return pos != nullptr && (pos == end || Tokenizer::is_separator(*pos));
+    }
+
+    // Whether a line is blank or only has separators
+    static bool is_blank(std::string_view line) {
+        return Tokenizer::skip_separators(line.data(), line.data() + line.size()) == line.data() + line.size();
+    }
+
+    // The symmetric graph over num_vertices vertices with the collected edges (and their reverse), without duplicates
+    Graph build(uint64_t num_vertices, int num_threads) const {
+        RangeSplitter rs(chunks.size(), num_threads);
+        return GraphBuilder::symmetrize(num_vertices, num_threads, [&](int thread_idx, auto &&emit) {
+            for (uint64_t chunk = rs.get_min(thread_idx); chunk < rs.get_max(thread_idx); chunk++)
+                for (const edge_t &edge : chunks[chunk])
+                    emit(edge.first, edge.second);
+        });
+    }
+};
+
+template <typename H, typename L>
+EdgeList EdgeList::read(const std::string &filename, int num_threads, bool direct_io, H &&parse_header, L &&parse_line) {
+    EdgeList list;
+    // Errors are reported once all threads are done, since an exception cannot cross a thread boundary
+    std::atomic<bool> invalid = false;
+    auto parse_range = [&](const char *begin, const char *end, std::vector<edge_t> &edges) {
+        Tokenizer::for_each_line(begin, end, [&](std::string_view line) {
+            if (!parse_line(line, edges))
+                invalid.store(true, std::memory_order_relaxed);
+        });
+    };
+
+    if (TextStream::is_streamed(filename, direct_io)) {
+        TextStream stream(filename);
+        std::string &first = stream.first_block();
+        const char *pos = first.data();
+        parse_header(pos, first.data() + first.size());
+        first.erase(0, pos - first.data());
+        std::mutex chunks_mutex;
+        stream.for_each_block(num_threads, [&](const TextStream::block_t &block) {
+            std::vector<edge_t> edges;
+            parse_range(block.text.data(), block.text.data() + block.text.size(), edges);
+            std::lock_guard<std::mutex> lock(chunks_mutex);
+            list.chunks.push_back(std::move(edges));
+        });
+        list.stats = stream.stats();
+    } else {
+        MappedFile file(filename);
+        const char *pos = reinterpret_cast<const char *>(file.data()), *end = pos + file.size();
+        list.stats.text_bytes = file.size();
+        parse_header(pos, end);
+        std::vector<const char *> boundaries = Tokenizer::split_lines(pos, end, num_threads);
+        list.chunks.resize(num_threads);
+        parallel_for(num_threads, num_threads, [&](int chunk, uint64_t, uint64_t) {
+            parse_range(boundaries[chunk], boundaries[chunk + 1], list.chunks[chunk]);
+        });
+    }
+    if (invalid)
+        throw std::runtime_error("Malformed edge or invalid vertex ID in " + filename);
+    return list;
+}
+
+#endif //GRAPH_COLORING_EDGELIST_H
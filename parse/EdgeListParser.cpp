@@ -0,0 +1,36 @@
+#include "EdgeListParser.h"
+#include "../utils/RangeSplitter.h"
+#include "EdgeList.h"
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+EdgeListParser::EdgeListParser(const std::string &filename, bool direct_io)
+    : filename(filename), num_threads(std::max(1u, std::thread::hardware_concurrency())), direct_io(direct_io) {}
+
+Graph EdgeListParser::parse() {
+    EdgeList edges = EdgeList::read(
+        filename, num_threads, direct_io,
+        [](const char *&, const char *) {},
+        [](std::string_view line, std::vector<EdgeList::edge_t> &out) {
+            const char *first = Tokenizer::skip_separators(line.data(), line.data() + line.size());
+            if (first == line.data() + line.size() || *first == '#' || *first == '%')
+                return true;
+            uint64_t from, to;
+            // The largest ID is reserved, and the vertex count must fit too
+            if (!EdgeList::parse_edge(line, from, to) || std::max(from, to) + 1 >= std::numeric_limits<vertex_t>::max())
+                return false;
+            out.emplace_back(from, to);
+            return true;
+        });
+    stats = edges.stats;
+
+    std::vector<uint64_t> max_ids(edges.chunks.size(), 0);
+    parallel_for(edges.chunks.size(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (uint64_t chunk = from; chunk < to; chunk++)
+            for (const auto &edge : edges.chunks[chunk])
+                max_ids[chunk] = std::max<uint64_t>(max_ids[chunk], std::max(edge.first, edge.second) + 1);
+    });
+    uint64_t num_vertices = max_ids.empty() ? 0 : *std::max_element(max_ids.begin(), max_ids.end());
+    return edges.build(num_vertices, num_threads);
+}
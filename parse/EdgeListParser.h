@@ -0,0 +1,26 @@
+#ifndef GRAPH_COLORING_EDGELISTPARSER_H
+#define GRAPH_COLORING_EDGELISTPARSER_H
+
+#include "../graph/Graph.h"
+#include "Parser.h"
+#include <string>
+
+/* EdgeListParser reads edge lists such as those of the SNAP collection: each line holds the IDs of the two endpoints
+ * of an edge, separated by whitespace and possibly followed by other fields (eg. a weight or a timestamp), which are
+ * ignored. Lines beginning with # or % are comments.
+ *
+ * IDs start from 0, and there is no header: the number of vertices is one more than the largest ID. Edges may be listed
+ * in one or both directions, and are symmetrized and deduplicated (see EdgeList).
+ */
+class EdgeListParser : public IParser {
+    std::string filename;
+    int num_threads;
+    bool direct_io;
+
+  public:
+    EdgeListParser(const std::string &filename, bool direct_io = false);
+
+    Graph parse();
+};
+
+#endif //GRAPH_COLORING_EDGELISTPARSER_H
@@ -0,0 +1,93 @@
+#ifndef GRAPH_COLORING_FASTFORMAT_H
+#define GRAPH_COLORING_FASTFORMAT_H
+
+#include "../utils/RangeSplitter.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+/* Layout of .fast files written by Serializer and read by FastParser.
+ *
+ * Version 1 (still readable) is a u32 vertex count followed by one length-prefixed list of u32 IDs per vertex.
+ *
+ * Version 2 stores the CSR arrays of the graph as they are in memory, so that the file can be mapped and used in place:
+ *  - the header below;
+ *  - the offsets array (num_vertices + 1 entries of offset_bits each), zero-padded to a multiple of 8 bytes;
+ *  - the neighbors array (num_edges entries of vertex_bits each).
+ * All sections start at a multiple of 8 bytes, so the arrays are suitably aligned in a mapping. Integers are stored in
+ * the byte order of the machine that wrote the file, which is recorded in the header.
+ */
+struct fast_header_t {
+    static constexpr char MAGIC[8] = {'G', 'C', 'F', 'A', 'S', 'T', '\0', '\0'};
+    static constexpr uint32_t VERSION = 2;
+    // Reads as 0x04030201 on a machine with the opposite byte order
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    // Properties of the adjacency lists, checked by Serializer
+    enum flags_t : uint32_t {
+        SORTED = 1 << 0,       // each list is in increasing order
+        DEDUPLICATED = 1 << 1, // no list contains the same neighbor twice
+        SYMMETRIC = 1 << 2,    // v is a neighbor of u whenever u is a neighbor of v
+        NO_SELF_LOOPS = 1 << 3, // no vertex is its own neighbor
+    };
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t vertex_bits;
+    uint32_t offset_bits;
+    uint64_t num_vertices;
+    uint64_t num_edges;
+    uint32_t flags;
+    uint32_t reserved;
+    // fast_checksum of the offsets and neighbors sections
+    uint64_t checksum;
+
+    bool has_magic() const { return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0; }
+
+    // Position of the arrays from the start of the file
+    uint64_t offsets_position() const { return sizeof(fast_header_t); }
+    uint64_t neighbors_position() const { return offsets_position() + (((num_vertices + 1) * (offset_bits / 8) + 7) & ~uint64_t(7)); }
+    uint64_t file_size() const { return neighbors_position() + num_edges * (vertex_bits / 8); }
+};
+
+static_assert(sizeof(fast_header_t) % 8 == 0, "Sections must be 8-byte aligned");
+
+/* Checksum of `size` bytes, seen as 8-byte words (the last one zero-padded) starting at word index first_word of the
+ * data following the header. Each word is mixed with its index and the results are summed, so the checksum of a
+ * section can be computed in parallel, and separately from the other sections.
+ */
+inline uint64_t fast_checksum(const uint8_t *data, uint64_t size, uint64_t first_word, int num_threads) {
+    auto mix = [](uint64_t word, uint64_t idx) {
+        // splitmix64 finalizer
+        uint64_t z = word + (idx + 1) * 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    };
+    uint64_t num_words = (size + 7) / 8;
+    std::atomic<uint64_t> checksum = 0;
+    parallel_for(num_words, num_threads, [&](int, uint64_t from, uint64_t to) {
+        uint64_t partial = 0;
+        for (uint64_t idx = from; idx < to; idx++) {
+            uint64_t word = 0;
+            std::memcpy(&word, data + idx * 8, std::min<uint64_t>(8, size - idx * 8));
+            partial += mix(word, first_word + idx);
+        }
+        checksum.fetch_add(partial, std::memory_order_relaxed);
+    });
+    return checksum;
+}
+
+/* Hash of a directed edge. The adjacency lists are symmetric iff the sum of hash(u, v) over all edges (u, v) equals
+ * that of hash(v, u), up to collisions with probability about 2^-64: this checks the SYMMETRIC flag while only reading
+ * the lists sequentially.
+ */
+inline uint64_t fast_edge_hash(uint64_t from, uint64_t to) {
+    uint64_t z = (from * 0x9e3779b97f4a7c15ull) ^ (to + 0x632be59bd9b4e019ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+#endif //GRAPH_COLORING_FASTFORMAT_H
@@ -1,24 +1,172 @@
 #include "FastParser.h"
+#include "../graph/GraphBuilder.h"
+#include "../utils/RangeSplitter.h"
 #include "Parser.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 
-FastParser::FastParser(std::ifstream &_file) : file(std::move(_file)) {}
+// Whether CSR arrays can be used safely: offsets start at 0, never decrease and end at num_edges, and every neighbor is
+// a valid vertex ID. Both arrays are scanned in parallel.
+template <typename O, typename V>
+static bool is_well_formed(const O *offsets, const V *neighbors, uint64_t num_vertices, uint64_t num_edges) {
+    if (offsets[0] != 0 || offsets[num_vertices] != num_edges)
+        return false;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<bool> valid = true;
+    parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (uint64_t vertex = from; vertex < to; vertex++)
+            if (offsets[vertex + 1] < offsets[vertex])
+                valid.store(false, std::memory_order_relaxed);
+    });
+    parallel_for(num_edges, num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (uint64_t idx = from; idx < to; idx++)
+            if (uint64_t(neighbors[idx]) >= num_vertices)
+                valid.store(false, std::memory_order_relaxed);
+    });
+    return valid;
+}
+
+FastParser::FastParser(const std::string &path, bool verify_checksum)
+    : file(std::make_shared<MappedFile>(path)), verify_checksum(verify_checksum) {}
 
 Graph FastParser::parse() {
-    uint32_t num_vertices = deserialize(file);
-    std::vector<adjacency_vec_t> vertices(num_vertices);
+    fast_header_t header;
+    if (file->size() >= sizeof(header)) {
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (header.has_magic())
+            return parse_v2(header);
+    }
+    return parse_v1();
+}
+
+Graph FastParser::parse_v1() {
+    const uint8_t *pos = file->data(), *end = file->data() + file->size();
+    auto remaining_words = [&pos, end]() { return uint64_t(end - pos) / sizeof(uint32_t); };
+    auto next_word = [&pos, &remaining_words]() {
+        if (remaining_words() == 0)
+            throw std::runtime_error("Truncated FastParser file");
+        uint32_t word;
+        std::memcpy(&word, pos, sizeof(word));
+        pos += sizeof(word);
+        return word;
+    };
+
+    uint32_t num_vertices = next_word();
+    if (num_vertices >= std::numeric_limits<vertex_t>::max())
+        throw std::runtime_error("Too many vertices for the configured vertex ID width");
+    GraphBuilder builder(num_vertices);
+    // The file holds one u32 per adjacency list length and one per neighbor, so the total number of neighbors can be
+    // computed from the file size and allocated at once
+    if (remaining_words() > num_vertices)
+        builder.reserve(remaining_words() - num_vertices);
 
     for (uint32_t i = 0; i < num_vertices; i++) {
-        adjacency_vec_t &edges = vertices[i];
-        uint32_t num_edges = deserialize(file);
-        edges.resize(num_edges);
-        for (uint32_t j = 0; j < num_edges; j++)
-            edges[j] = deserialize(file);
+        uint32_t num_edges = next_word();
+        if (remaining_words() < num_edges)
+            throw std::runtime_error("Truncated FastParser file");
+        auto edges = builder.append_row(num_edges);
+        if constexpr (std::is_same_v<vertex_t, uint32_t>) {
+            // Adjacency lists are stored contiguously, so they can be copied at once
+            std::memcpy(edges.data(), pos, size_t(num_edges) * sizeof(uint32_t));
+            pos += size_t(num_edges) * sizeof(uint32_t);
+        } else {
+            // The file always stores u32 IDs, so they must be converted one by one
+            for (auto &edge : edges)
+                edge = next_word();
+        }
     }
-    return Graph(std::move(vertices));
+    Graph graph = builder.build();
+
+    // Version 1 files have no checksum, so the neighbor IDs are at least checked to be vertices
+    std::atomic<bool> out_of_range = false;
+    parallel_for(num_vertices, std::max(1u, std::thread::hardware_concurrency()), [&](int, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; vertex++)
+            for (vertex_t neighbor : graph.neighbors_of(vertex))
+                if (neighbor >= num_vertices)
+                    out_of_range.store(true, std::memory_order_relaxed);
+    });
+    if (out_of_range)
+        throw std::runtime_error("Malformed FastParser file");
+    return graph;
 }
 
-uint32_t FastParser::deserialize(std::istream &out) {
-    uint32_t ret;
-    out.read(reinterpret_cast<char *>(&ret), sizeof(uint32_t));
-    return ret;
+Graph FastParser::parse_v2(const fast_header_t &header) {
+    if (header.version != fast_header_t::VERSION)
+        throw std::runtime_error("Unsupported FastParser file version " + std::to_string(header.version));
+    if (header.byte_order != fast_header_t::BYTE_ORDER_MARK)
+        throw std::runtime_error("FastParser file was written on a machine with a different byte order");
+    bool known_widths = (header.vertex_bits == 16 || header.vertex_bits == 32 || header.vertex_bits == 64) &&
+                        (header.offset_bits == 32 || header.offset_bits == 64);
+    if (!known_widths)
+        throw std::runtime_error("Malformed FastParser file");
+    flags = header.flags;
+    // Bound the counts before computing sizes from them, so that a corrupt header cannot overflow
+    if (header.num_vertices >= file->size() || header.num_edges > file->size() || file->size() < header.file_size())
+        throw std::runtime_error("Truncated FastParser file");
+    if (header.num_vertices >= std::numeric_limits<vertex_t>::max())
+        throw std::runtime_error("Too many vertices for the configured vertex ID width");
+
+    if (header.vertex_bits == GRAPH_VERTEX_BITS && header.offset_bits == GRAPH_OFFSET_BITS) {
+        auto offsets = reinterpret_cast<const offset_t *>(file->data() + header.offsets_position());
+        auto neighbors = reinterpret_cast<const vertex_t *>(file->data() + header.neighbors_position());
+        if (verify_checksum)
+            check(header);
+        // The solvers index arrays with the offsets and neighbors without bounds checks, so a damaged file must be
+        // rejected here rather than crash them
+        if (!is_well_formed(offsets, neighbors, header.num_vertices, header.num_edges))
+            throw std::runtime_error("Malformed FastParser file");
+        return Graph(file, offsets, neighbors, header.num_vertices, header.num_edges);
+    }
+
+    switch (header.vertex_bits * 100 + header.offset_bits) {
+    case 1632:
+        return convert<uint16_t, uint32_t>(header);
+    case 1664:
+        return convert<uint16_t, uint64_t>(header);
+    case 3232:
+        return convert<uint32_t, uint32_t>(header);
+    case 3264:
+        return convert<uint32_t, uint64_t>(header);
+    case 6432:
+        return convert<uint64_t, uint32_t>(header);
+    default:
+        return convert<uint64_t, uint64_t>(header);
+    }
+}
+
+void FastParser::check(const fast_header_t &header) const {
+    const uint8_t *arrays = file->data() + header.offsets_position();
+    uint64_t checksum = fast_checksum(arrays, header.file_size() - header.offsets_position(), 0, std::max(1u, std::thread::hardware_concurrency()));
+    if (checksum != header.checksum)
+        throw std::runtime_error("Corrupt FastParser file (checksum mismatch)");
+}
+
+template <typename FileV, typename FileO>
+Graph FastParser::convert(const fast_header_t &header) {
+    check(header);
+    auto offsets = reinterpret_cast<const FileO *>(file->data() + header.offsets_position());
+    auto neighbors = reinterpret_cast<const FileV *>(file->data() + header.neighbors_position());
+    vertex_t num_vertices = header.num_vertices;
+    // IDs that do not fit in vertex_t are out of range too
+    if (header.num_edges > std::numeric_limits<offset_t>::max() || !is_well_formed(offsets, neighbors, num_vertices, header.num_edges))
+        throw std::runtime_error("Malformed FastParser file");
+
+    GraphBuilder builder(num_vertices);
+    for (vertex_t vertex = 0; vertex < num_vertices; vertex++)
+        builder.set_degree(vertex, offsets[vertex + 1] - offsets[vertex]);
+    builder.compute_offsets();
+
+    // Lists are independent, so they are converted in parallel
+    parallel_for(num_vertices, std::max(1u, std::thread::hardware_concurrency()), [&](int, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; vertex++) {
+            auto slot = builder.neighbors_of(vertex);
+            std::copy_n(neighbors + offsets[vertex], slot.size(), slot.begin());
+        }
+    });
+    return builder.build();
 }
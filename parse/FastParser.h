@@ -1,17 +1,39 @@
 #ifndef GRAPH_COLORING_FASTPARSER1_H
 #define GRAPH_COLORING_FASTPARSER1_H
 
+#include "../utils/MappedFile.h"
+#include "FastFormat.h"
 #include "Parser.h"
-#include <fstream>
+#include <memory>
 
+/* FastParser reads .fast files (see FastFormat.h) through a memory mapping.
+ *
+ * Version 2 files written with the configured vertex and offset widths are not parsed at all: the graph is a view over
+ * the arrays in the mapping, which stays alive as long as the graph does, and whose pages are shared with other
+ * processes using the same file. Since the solvers trust the CSR arrays, they are still scanned once in parallel, to
+ * check that the offsets never decrease and that every neighbor is a vertex; a damaged file is rejected rather than
+ * read out of bounds. Other widths are converted into a new graph, and version 1 files are copied list by list, with
+ * the same checks. Files written on a machine with another byte order are rejected.
+ */
 class FastParser : public IParser {
-    std::ifstream file;
+    std::shared_ptr<MappedFile> file;
+    bool verify_checksum;
 
-    // Deserialize a single u32
-    static uint32_t deserialize(std::istream &out);
+    Graph parse_v1();
+    Graph parse_v2(const fast_header_t &);
+    // Throw if the checksum of a version 2 file does not match its header
+    void check(const fast_header_t &) const;
+    // Copy CSR arrays stored with other widths than the configured ones
+    template <typename FileV, typename FileO>
+    Graph convert(const fast_header_t &);
 
   public:
-    FastParser(std::ifstream &);
+    // The checksum of mapped version 2 files is only verified on request, since their structure is checked anyway
+    // (converted files are always verified)
+    FastParser(const std::string &path, bool verify_checksum = false);
+
+    // The flags of the parsed file (see fast_header_t); version 1 files have none
+    uint32_t flags = 0;
 
     Graph parse();
 };
@@ -0,0 +1,71 @@
+#include "MatrixMarketParser.h"
+#include "EdgeList.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+MatrixMarketParser::MatrixMarketParser(const std::string &filename, bool direct_io)
+    : filename(filename), num_threads(std::max(1u, std::thread::hardware_concurrency())), direct_io(direct_io) {}
+
+uint64_t MatrixMarketParser::parse_header(const char *&pos, const char *end) {
+    auto next_line = [&pos, end]() {
+        auto newline = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+        std::string_view line(pos, (newline ? newline : end) - pos);
+        pos = newline ? newline + 1 : end;
+        return line;
+    };
+
+    // %%MatrixMarket matrix coordinate <field> <symmetry>, case-insensitive
+    std::string banner(next_line());
+    std::transform(banner.begin(), banner.end(), banner.begin(), [](unsigned char c) { return std::tolower(c); });
+    std::istringstream banner_stream(banner);
+    std::string magic, object, format;
+    banner_stream >> magic >> object >> format;
+    if (magic != "%%matrixmarket" || object != "matrix")
+        throw std::runtime_error("Not a Matrix Market file");
+    if (format != "coordinate")
+        throw std::runtime_error("Unsupported Matrix Market format " + format + " (only coordinate matrices are graphs)");
+
+    std::string_view size_line;
+    do {
+        if (pos == end)
+            throw std::runtime_error("Missing Matrix Market size line");
+        size_line = next_line();
+    } while (size_line.empty() || size_line[0] == '%' || EdgeList::is_blank(size_line));
+
+    // rows columns entries
+    std::vector<uint64_t> sizes;
+    const char *size_end = size_line.data() + size_line.size();
+    if (Tokenizer::parse_uints(size_line.data(), size_end, [&sizes](uint64_t value) { sizes.push_back(value); }) != size_end || sizes.size() != 3)
+        throw std::runtime_error("Malformed Matrix Market size line");
+    if (sizes[0] != sizes[1])
+        throw std::runtime_error("Matrix Market matrix is not square");
+    if (sizes[0] >= std::numeric_limits<vertex_t>::max())
+        throw std::runtime_error("Too many vertices for the configured vertex ID width");
+    return sizes[0];
+}
+
+Graph MatrixMarketParser::parse() {
+    uint64_t num_vertices = 0;
+    EdgeList edges = EdgeList::read(
+        filename, num_threads, direct_io,
+        [&num_vertices](const char *&pos, const char *end) { num_vertices = parse_header(pos, end); },
+        [&num_vertices](std::string_view line, std::vector<EdgeList::edge_t> &out) {
+            if (EdgeList::is_blank(line) || line[0] == '%')
+                return true;
+            uint64_t row, column;
+            // Indices start from 1
+            if (!EdgeList::parse_edge(line, row, column) || row == 0 || column == 0 || row > num_vertices || column > num_vertices)
+                return false;
+            // The diagonal does not describe edges
+            if (row != column)
+                out.emplace_back(row - 1, column - 1);
+            return true;
+        });
+    stats = edges.stats;
+    return edges.build(num_vertices, num_threads);
+}
@@ -0,0 +1,29 @@
+#ifndef GRAPH_COLORING_MATRIXMARKETPARSER_H
+#define GRAPH_COLORING_MATRIXMARKETPARSER_H
+
+#include "../graph/Graph.h"
+#include "Parser.h"
+#include <string>
+
+/* MatrixMarketParser reads the sparsity pattern of a square matrix in Matrix Market coordinate format (eg. from the
+ * SuiteSparse collection) as the graph with an edge {i, j} for each nonzero entry (i, j) off the diagonal.
+ *
+ * Any field (pattern, real, integer, complex) and symmetry is accepted: values are ignored, and the pattern is
+ * symmetrized, so a general matrix A yields the graph of A + A^T. Entries are parsed in parallel (see EdgeList).
+ */
+class MatrixMarketParser : public IParser {
+    std::string filename;
+    int num_threads;
+    bool direct_io;
+
+  public:
+    MatrixMarketParser(const std::string &filename, bool direct_io = false);
+
+    // Parse the banner, comments and size line at pos, and return the number of vertices; pos is moved to the first
+    // entry
+    static uint64_t parse_header(const char *&pos, const char *end);
+
+    Graph parse();
+};
+
+#endif //GRAPH_COLORING_MATRIXMARKETPARSER_H
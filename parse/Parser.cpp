@@ -1,54 +1,160 @@
 #include "Parser.h"
+#include "../graph/GraphBuilder.h"
+#include "../utils/Decompressor.h"
 #include "Dimacs10Parser.h"
 #include "DimacsParser.h"
+#include "EdgeListParser.h"
 #include "FastParser.h"
+#include "MatrixMarketParser.h"
 #include "Serializer.h"
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
 
-Parser::Parser(const std::string &_path) {
+// Like the text parsers, the Sanitizer uses every core
+static int hardware_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+Parser::Parser(const std::string &_path, const ParserOptions &options)
+    : path(_path), options(options), cache(options.cache_directory, options.cache_size_limit) {
     std::ifstream file(_path);
     if (!file.is_open())
         throw std::runtime_error("Failed to open file.");
 
-    auto path = std::filesystem::path(_path);
-
-    if (path.extension() == ".fast") {
-        serializable = false;
-        parser = new FastParser(file);
-    } else if (path.extension() == ".graph") {
-        serializable = true;
-        fast_filename = _path + ".fast";
-        parser = new Dimacs10Parser(file, _path);
-    } else if (path.extension() == ".gra") {
-        serializable = true;
-        fast_filename = _path + ".fast";
-        parser = new DimacsParser(file, _path);
-    } else {
-        throw std::runtime_error("Unrecognized extension: ." + path.extension().string());
-    }
-    metadata.filename = path.filename().string();
+    // Text files may be compressed, eg. road.gra.gz; .fast files are mapped, so they may not
+    auto extension = std::filesystem::path(Decompressor::strip_extension(_path)).extension();
+    bool compressed = Decompressor::format_of(_path) != Decompressor::NONE;
+    if ((extension != ".fast" || compressed) && extension != ".graph" && extension != ".gra" && extension != ".mtx" &&
+        !is_edge_list(extension.string()))
+        throw std::runtime_error("Unrecognized extension: " + std::filesystem::path(_path).filename().string());
+    metadata.filename = std::filesystem::path(_path).filename().string();
 }
 
 Parser::~Parser() {
-    delete parser;
+    if (cache_writer.joinable())
+        cache_writer.join();
+}
+
+bool Parser::is_edge_list(const std::string &extension) {
+    return extension == ".txt" || extension == ".edges" || extension == ".el";
+}
+
+std::unique_ptr<IParser> Parser::text_parser(const std::string &path, bool direct_io) {
+    auto extension = std::filesystem::path(Decompressor::strip_extension(path)).extension();
+    if (extension == ".graph")
+        return std::make_unique<Dimacs10Parser>(path, direct_io);
+    if (extension == ".mtx")
+        return std::make_unique<MatrixMarketParser>(path, direct_io);
+    if (is_edge_list(extension.string()))
+        return std::make_unique<EdgeListParser>(path, direct_io);
+    return std::make_unique<DimacsParser>(path, direct_io);
 }
 
 Graph Parser::parse() {
-    // Time the parsing
+    // Time the parsing, including the cache lookup
     auto t1 = std::chrono::high_resolution_clock::now();
-    Graph g = parser->parse();
+    Graph g = std::filesystem::path(path).extension() == ".fast" ? parse_fast(path) : parse_cached();
     auto t2 = std::chrono::high_resolution_clock::now();
     milliseconds = std::chrono::duration<double, std::milli>(t2 - t1).count();
     metadata.num_vertices = g.num_vertices();
-    for (const auto &neighbors : g.neighbor_indices)
-        metadata.num_edges += neighbors.size();
-    // If we're not using FastParser, serialize the graph to a .fast file
-    if (serializable) {
-        std::ofstream fast_file(fast_filename);
-        if (!fast_file.is_open())
-            throw std::runtime_error("Failed to open FastParser file for writing.");
-        Serializer s(g, fast_file);
+    metadata.num_edges = g.num_edges();
+    return g;
+}
+
+Graph Parser::parse_fast(const std::string &fast_path, bool is_cache) {
+    FastParser parser(fast_path, options.verify_fast);
+    Graph g = parser.parse();
+    if (is_cache && !options.sanitize && !(parser.flags & fast_header_t::SYMMETRIC) && !GraphBuilder::is_symmetric(g, hardware_threads()))
+        g = GraphBuilder::symmetrize(g, hardware_threads());
+    if (options.sanitize) {
+        Sanitizer sanitizer(options.enforce_symmetry, hardware_threads());
+        if (!sanitizer.skip(parser.flags))
+            g = sanitizer.apply(std::move(g));
+        sanitize_report = sanitizer.report;
+    }
+    return g;
+}
+
+Graph Parser::parse_cached() {
+    // 1 for checked and 2 for enforced symmetry
+    uint64_t variant = options.sanitize ? 1 + options.enforce_symmetry : 0;
+    // Files read with direct I/O are hashed by their TextStream, so that they are only read once, from the device
+    bool hash_while_parsing = options.use_cache && TextStream::is_streamed(path, options.direct_io) &&
+                              Decompressor::format_of(path) == Decompressor::NONE;
+    if (options.use_cache && !hash_while_parsing)
+        fast_filename = cache.entry_path(path, CacheManager::hash_contents(path), variant);
+    if (!fast_filename.empty() && std::filesystem::exists(fast_filename)) {
+        try {
+            Graph g = parse_fast(fast_filename, true);
+            CacheManager::touch(fast_filename);
+            return g;
+        } catch (const std::runtime_error &e) {
+            // A damaged cache is replaced by parsing the source again
+            std::cerr << "Ignoring " << fast_filename << ": " << e.what() << std::endl;
+            std::error_code ignored;
+            std::filesystem::remove(fast_filename, ignored);
+        }
+    }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::unique_ptr<IParser> parser = text_parser(path, options.direct_io);
+    Graph g = parser->parse();
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(t2 - t1).count();
+    if (seconds > 0)
+        text_throughput = parser->stats.text_bytes / 1048576.0 / seconds;
+    if (parser->stats.read_seconds > 0)
+        read_throughput = parser->stats.text_bytes / 1048576.0 / parser->stats.read_seconds;
+    if (options.sanitize) {
+        Sanitizer sanitizer(options.enforce_symmetry, hardware_threads());
+        g = sanitizer.apply(std::move(g));
+        sanitize_report = sanitizer.report;
+    }
+    if (!options.use_cache)
+        return g;
+    if (hash_while_parsing) {
+        fast_filename = cache.entry_path(path, *parser->stats.contents_checksum, variant);
+        // The source was parsed anyway, but its cache may be up to date
+        if (std::filesystem::exists(fast_filename)) {
+            CacheManager::touch(fast_filename);
+            return g;
+        }
     }
+    // Serialize the graph to the cache in the background. The graph is moved to shared storage and a view over it is
+    // returned, so that the arrays stay alive until the writer is done with them even if the caller replaces the graph
+    // (eg. with a reordered one).
+    auto shared = std::make_shared<const Graph>(std::move(g));
+    g = Graph(shared, shared->offsets_array().data(), shared->neighbors_array().data(), shared->num_vertices(), shared->num_edges());
+    cache_writer = std::thread(&Parser::write_cache, this, std::move(shared));
     return g;
 }
+
+void Parser::write_cache(std::shared_ptr<const Graph> graph) const {
+    // A crash or a concurrent reader must never see a partial file, so write to a temporary one and rename it
+    std::string temp_filename = fast_filename + ".tmp" + std::to_string(getpid());
+    try {
+        std::filesystem::path directory = std::filesystem::path(fast_filename).parent_path();
+        if (!directory.empty())
+            std::filesystem::create_directories(directory);
+        {
+            std::ofstream fast_file(temp_filename, std::ios::binary);
+            if (!fast_file.is_open())
+                throw std::runtime_error("Failed to open FastParser file for writing.");
+            // A single thread, so as not to compete with the solvers
+            Serializer s(*graph, fast_file, 1);
+            if (fast_file.fail())
+                throw std::runtime_error("Failed to write FastParser file.");
+        }
+        std::filesystem::rename(temp_filename, fast_filename);
+        cache.evict(fast_filename);
+    } catch (const std::exception &e) {
+        // The cache is an optimization, so failing to write it is not fatal
+        std::error_code ignored;
+        std::filesystem::remove(temp_filename, ignored);
+        std::cerr << "Could not write " << fast_filename << ": " << e.what() << std::endl;
+    }
+}
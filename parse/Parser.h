@@ -2,30 +2,95 @@
 #define GRAPH_COLORING_PARSER_H
 
 #include "../graph/Graph.h"
+#include "CacheManager.h"
+#include "Sanitizer.h"
+#include "TextStream.h"
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
 
 // Parser interface
 class IParser {
   public:
+    // What a text parser read: the whole file if it was mapped, or what its TextStream reports
+    TextStream::stats_t stats;
+
     virtual ~IParser() = default;
     virtual Graph parse() = 0;
 };
 
+struct ParserOptions {
+    // Check the checksum of mapped .fast files, which requires reading them in full
+    bool verify_fast = false;
+    // Read and write .fast caches of text files; if disabled, sources are not hashed either
+    bool use_cache = true;
+    // Directory of the .fast caches; if empty, each cache is stored next to its source
+    std::string cache_directory;
+    // Total size of the caches in a directory above which the least recently used ones are evicted; 0 for no limit.
+    // Entries of edited or deleted sources are never used again, so the default limit keeps them from piling up.
+    uint64_t cache_size_limit = 16ull * 1024 * 1024 * 1024;
+    // Run the Sanitizer after parsing, adding missing reverse edges or only counting them
+    bool sanitize = false;
+    bool enforce_symmetry = true;
+    // Read uncompressed text files with O_DIRECT and io_uring (see BlockReader) instead of mapping them, for cold loads
+    // from fast devices
+    bool direct_io = false;
+};
+
+/* Parser picks the parser for a file by its extension.
+ *
+ * Text files are cached as .fast files, keyed by the size, modification time and contents of the source (see
+ * CacheManager): if the source is unchanged, the graph is read from its cache instead. Otherwise the cache is written
+ * by a background thread, so that solving can start as soon as the graph is parsed, into a temporary file that is
+ * renamed into place once complete. Files read with direct I/O are always parsed, since the point is to read them from
+ * the device: they are hashed from the blocks the parser reads rather than before, and their cache is written if it
+ * is missing.
+ *
+ * If requested, the graph is sanitized after parsing, unless the flags of its .fast file say it is already clean.
+ * Sanitized graphs are cached separately from plain ones, so a sanitized cache entry is loaded without the pass.
+ */
 class Parser {
-    IParser *parser;
-    bool serializable;
+    std::string path;
+    ParserOptions options;
+    CacheManager cache;
     std::string fast_filename;
+    std::thread cache_writer;
+
+    // Extensions of edge lists (see EdgeListParser)
+    static bool is_edge_list(const std::string &extension);
+    // Parser for a text file, by extension
+    static std::unique_ptr<IParser> text_parser(const std::string &path, bool direct_io);
+    // Parse a text file through its cache, and start writing the cache if it is missing
+    Graph parse_cached();
+    // Parse a .fast file, and sanitize it if requested and its flags do not say it is clean. A cache entry of a plain
+    // graph is symmetrized if it is not symmetric, as the text parsers would have done: entries written by
+    // StreamingConverter keep the rows of the source as they are.
+    Graph parse_fast(const std::string &fast_path, bool is_cache = false);
+    // Serialize the graph to fast_filename; runs on cache_writer
+    void write_cache(std::shared_ptr<const Graph> graph) const;
 
   public:
     using metadata_t = struct {
         std::string filename;
-        int num_vertices, num_edges;
+        uint64_t num_vertices, num_edges;
     };
 
     double milliseconds;
+    // Throughput of the text parser in MB/s of text (after decompression, and excluding the cache lookup), or 0 if the
+    // graph was loaded from a .fast file
+    double text_throughput = 0;
+    // Rate at which a file read with direct I/O came from the device, in MB/s over the time reads were in flight, or 0.
+    // It is close to the device bandwidth if the parsers keep up, and bounds the text throughput.
+    double read_throughput = 0;
 
     metadata_t metadata;
 
-    Parser(const std::string &filename);
+    // What the Sanitizer did, if it was requested
+    std::optional<Sanitizer::report_t> sanitize_report;
+
+    Parser(const std::string &filename, const ParserOptions &options = ParserOptions());
+    // Waits for the cache to be written
     ~Parser();
 
     Graph parse();
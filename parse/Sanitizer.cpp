@@ -0,0 +1,122 @@
+#include "Sanitizer.h"
+#include "../graph/GraphBuilder.h"
+#include "../utils/RangeSplitter.h"
+#include "FastFormat.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+const uint32_t Sanitizer::CLEAN_FLAGS = fast_header_t::SORTED | fast_header_t::DEDUPLICATED | fast_header_t::SYMMETRIC | fast_header_t::NO_SELF_LOOPS;
+
+Sanitizer::Sanitizer(bool enforce_symmetry, int num_threads) : num_threads(num_threads), enforce_symmetry(enforce_symmetry) {}
+
+bool Sanitizer::skip(uint32_t fast_flags) {
+    report = {};
+    report.skipped = (fast_flags & CLEAN_FLAGS) == CLEAN_FLAGS;
+    return report.skipped;
+}
+
+// Sort the row, and remove the vertex itself, IDs that are not vertices and duplicates from it; return the number of
+// self-loops removed, and add the number of out-of-range IDs removed to out_of_range
+static uint64_t clean_row(vertex_t vertex, adjacency_vec_t &row, vertex_t num_vertices, uint64_t &out_of_range) {
+    std::sort(row.begin(), row.end());
+    auto invalid = std::lower_bound(row.begin(), row.end(), num_vertices);
+    out_of_range += row.end() - invalid;
+    row.erase(invalid, row.end());
+    auto self = std::equal_range(row.begin(), row.end(), vertex);
+    uint64_t self_loops = self.second - self.first;
+    row.erase(self.first, self.second);
+    row.erase(std::unique(row.begin(), row.end()), row.end());
+    return self_loops;
+}
+
+Graph Sanitizer::apply(Graph &&graph) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    report = {};
+    const vertex_t num_vertices = graph.num_vertices();
+
+    // First pass: find the rows that need fixing, and their size once fixed
+    struct partial_t {
+        uint64_t self_loops = 0, duplicates = 0, out_of_range = 0, unsorted_rows = 0;
+    };
+    std::vector<partial_t> partials(num_threads);
+    std::vector<vertex_t> degrees(num_vertices);
+    std::vector<uint8_t> dirty(num_vertices, 0);
+    parallel_for(num_vertices, num_threads, [&](int thread_idx, uint64_t from, uint64_t to) {
+        partial_t &partial = partials[thread_idx];
+        adjacency_vec_t buffer;
+        for (vertex_t vertex = from; vertex < to; vertex++) {
+            auto row = graph.neighbors_of(vertex);
+            // A strictly increasing row is sorted and has no duplicates, and its IDs are in range if the last one is
+            bool clean = std::adjacent_find(row.begin(), row.end(), std::greater_equal<vertex_t>()) == row.end() &&
+                         (row.empty() || row.back() < num_vertices) && !std::binary_search(row.begin(), row.end(), vertex);
+            degrees[vertex] = row.size();
+            if (clean)
+                continue;
+            dirty[vertex] = 1;
+            partial.unsorted_rows += !std::is_sorted(row.begin(), row.end());
+            buffer.assign(row.begin(), row.end());
+            uint64_t out_of_range = 0;
+            uint64_t self_loops = clean_row(vertex, buffer, num_vertices, out_of_range);
+            partial.self_loops += self_loops;
+            partial.out_of_range += out_of_range;
+            partial.duplicates += row.size() - self_loops - out_of_range - buffer.size();
+            degrees[vertex] = buffer.size();
+        }
+    });
+    for (const auto &partial : partials) {
+        report.self_loops += partial.self_loops;
+        report.duplicates += partial.duplicates;
+        report.out_of_range += partial.out_of_range;
+        report.unsorted_rows += partial.unsorted_rows;
+    }
+
+    // Second pass: copy the clean rows and fix the others
+    if (report.changed()) {
+        GraphBuilder builder(num_vertices);
+        parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+            for (vertex_t vertex = from; vertex < to; vertex++)
+                builder.set_degree(vertex, degrees[vertex]);
+        });
+        builder.compute_offsets();
+        parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+            adjacency_vec_t buffer;
+            for (vertex_t vertex = from; vertex < to; vertex++) {
+                auto row = graph.neighbors_of(vertex);
+                if (dirty[vertex]) {
+                    buffer.assign(row.begin(), row.end());
+                    uint64_t ignored = 0;
+                    clean_row(vertex, buffer, num_vertices, ignored);
+                    std::copy(buffer.begin(), buffer.end(), builder.neighbors_of(vertex).begin());
+                } else {
+                    std::copy(row.begin(), row.end(), builder.neighbors_of(vertex).begin());
+                }
+            }
+        });
+        graph = builder.build();
+    }
+    degrees = {};
+    dirty = {};
+
+    // Rows are now sorted and in range, so if the hashes say that the graph is not symmetric, the reverse of each edge
+    // can be looked up with a binary search
+    if (!GraphBuilder::is_symmetric(graph, num_threads)) {
+        std::atomic<uint64_t> asymmetric = 0;
+        parallel_for(num_vertices, num_threads, [&](int, uint64_t from, uint64_t to) {
+            uint64_t partial = 0;
+            for (vertex_t vertex = from; vertex < to; vertex++)
+                for (vertex_t neighbor : graph.neighbors_of(vertex)) {
+                    auto reverse = graph.neighbors_of(neighbor);
+                    partial += !std::binary_search(reverse.begin(), reverse.end(), vertex);
+                }
+            asymmetric.fetch_add(partial, std::memory_order_relaxed);
+        });
+        report.asymmetric_edges = asymmetric;
+        if (enforce_symmetry && report.asymmetric_edges != 0)
+            graph = GraphBuilder::symmetrize(graph, num_threads);
+    }
+
+    auto t2 = std::chrono::high_resolution_clock::now();
+    report.milliseconds = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    return std::move(graph);
+}
@@ -0,0 +1,51 @@
+#ifndef GRAPH_COLORING_SANITIZER_H
+#define GRAPH_COLORING_SANITIZER_H
+
+#include "../graph/Graph.h"
+#include <cstdint>
+
+/* Sanitizer removes what the solvers cannot handle from a parsed graph: self-loops (which no coloring satisfies),
+ * neighbor IDs that are not vertices (which would be read out of bounds), duplicate neighbors (which only add work)
+ * and unsorted rows, and checks that the graph is symmetric, optionally adding the missing reverse edges. Rows are
+ * cleaned before any neighbor is looked up.
+ *
+ * Rows are checked in parallel, and only the rows with problems are copied and fixed; a clean graph is returned as is.
+ * Symmetry is checked with the same sum of edge hashes as the SYMMETRIC flag of .fast files (see FastFormat.h), and
+ * the asymmetric edges are only looked up if it fails. A .fast file written from a sanitized graph has all of
+ * CLEAN_FLAGS set, so loading it again does not require this pass.
+ */
+class Sanitizer {
+    int num_threads;
+    bool enforce_symmetry;
+
+  public:
+    // The .fast flags that make the pass unnecessary
+    static const uint32_t CLEAN_FLAGS;
+
+    // What the last call to apply() found and changed
+    struct report_t {
+        // Self-loops and duplicate neighbors removed, counted in both rows for undirected edges
+        uint64_t self_loops = 0, duplicates = 0;
+        // Neighbor IDs removed because they are not below the number of vertices
+        uint64_t out_of_range = 0;
+        // Rows that were not sorted
+        uint64_t unsorted_rows = 0;
+        // Edges (u, v) without (v, u): added if symmetry is enforced, kept otherwise
+        uint64_t asymmetric_edges = 0;
+        double milliseconds = 0;
+        // The graph was known to be clean from the flags of its .fast file
+        bool skipped = false;
+
+        bool changed() const { return self_loops != 0 || duplicates != 0 || out_of_range != 0 || unsorted_rows != 0; }
+    };
+    report_t report;
+
+    Sanitizer(bool enforce_symmetry, int num_threads = 1);
+
+    // Return the sanitized graph, which is the given one if nothing had to change
+    Graph apply(Graph &&);
+    // Skip the pass for a graph whose .fast flags say it is already clean
+    bool skip(uint32_t fast_flags);
+};
+
+#endif //GRAPH_COLORING_SANITIZER_H
@@ -1,11 +1,73 @@
 #include "Serializer.h"
+#include "../graph/GraphBuilder.h"
+#include "../utils/RangeSplitter.h"
+#include "FastFormat.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 
-Serializer::Serializer(const Graph &graph, std::ostream &ostream) : graph(graph), ostream(ostream) {
-    serialize(graph.neighbor_indices);
+Serializer::Serializer(const Graph &graph, std::ostream &ostream, int num_threads)
+    : graph(graph), ostream(ostream), num_threads(num_threads) {
+    auto offsets = graph.offsets_array();
+    auto neighbors = graph.neighbors_array();
+
+    fast_header_t header = {};
+    std::memcpy(header.magic, fast_header_t::MAGIC, sizeof(header.magic));
+    header.version = fast_header_t::VERSION;
+    header.byte_order = fast_header_t::BYTE_ORDER_MARK;
+    header.vertex_bits = GRAPH_VERTEX_BITS;
+    header.offset_bits = GRAPH_OFFSET_BITS;
+    header.num_vertices = graph.num_vertices();
+    header.num_edges = graph.num_edges();
+    header.flags = compute_flags();
+    // The padding after the offsets is zero, as is the padding of the last word in fast_checksum
+    uint64_t neighbors_word = (header.neighbors_position() - header.offsets_position()) / 8;
+    header.checksum = fast_checksum(reinterpret_cast<const uint8_t *>(offsets.data()), offsets.size_bytes(), 0, num_threads) +
+                      fast_checksum(reinterpret_cast<const uint8_t *>(neighbors.data()), neighbors.size_bytes(), neighbors_word, num_threads);
+    write(&header, sizeof(header));
+
+    write(offsets.data(), offsets.size_bytes());
+    // Pad the offsets so that the neighbors start at a multiple of 8 bytes
+    static const char padding[8] = {};
+    write(padding, header.neighbors_position() - header.offsets_position() - offsets.size_bytes());
+    write(neighbors.data(), neighbors.size_bytes());
     // Ensure that the fastparse graph was written, so that crashes do not result in a malformed file
     ostream.flush();
 }
 
-void Serializer::serialize(uint32_t vertex) {
-    ostream.write(reinterpret_cast<const char *>(&vertex), sizeof(uint32_t));
+void Serializer::write(const void *data, uint64_t size) {
+    ostream.write(static_cast<const char *>(data), std::streamsize(size));
+}
+
+uint32_t Serializer::compute_flags() const {
+    std::atomic<bool> sorted = true, deduplicated = true, no_self_loops = true;
+    parallel_for(graph.num_vertices(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; vertex++) {
+            auto neighbors = graph.neighbors_of(vertex);
+            if (std::find(neighbors.begin(), neighbors.end(), vertex) != neighbors.end())
+                no_self_loops.store(false, std::memory_order_relaxed);
+            // Duplicates are found as adjacent equal items, so they are only checked in sorted lists
+            auto unordered = std::adjacent_find(neighbors.begin(), neighbors.end(), std::greater_equal<vertex_t>());
+            if (unordered != neighbors.end()) {
+                deduplicated.store(false, std::memory_order_relaxed);
+                if (*unordered > *(unordered + 1) || !std::is_sorted(unordered, neighbors.end()))
+                    sorted.store(false, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    // The graph is symmetric iff the multiset of edges (u, v) equals that of the reversed edges (v, u)
+    bool symmetric = GraphBuilder::is_symmetric(graph, num_threads);
+
+    uint32_t flags = 0;
+    if (sorted)
+        flags |= fast_header_t::SORTED;
+    // Duplicates were only looked for as adjacent items, which requires sorted lists
+    if (sorted && deduplicated)
+        flags |= fast_header_t::DEDUPLICATED;
+    if (symmetric)
+        flags |= fast_header_t::SYMMETRIC;
+    if (no_self_loops)
+        flags |= fast_header_t::NO_SELF_LOOPS;
+    return flags;
 }
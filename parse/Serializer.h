@@ -5,36 +5,22 @@
 #include <ostream>
 #include <string>
 
-// Serializes a given graph to a stream (typically a file) for usage with FastParser.
+// Serializes a given graph to a stream (typically a file) for usage with FastParser, in the version 2 format (see
+// FastFormat.h): the CSR arrays are written as they are in memory, with one large write each, so that FastParser can
+// map them back.
 class Serializer {
   private:
     const Graph &graph;
     std::ostream &ostream;
+    int num_threads;
 
-    // Serialize a single vertex (or generic u32)
-    void serialize(uint32_t vertex);
-
-    // Serialize as a length-prefixed vector
-    template <typename T>
-    void serialize(std::vector<T> vector) {
-        // Length prefix (standardized to u32)
-        serialize(static_cast<uint32_t>(vector.size()));
-        // Then serialize each member (possibly recursively, eg. if we have a vector of adjacency lists)
-        for (const T &item : vector)
-            serialize(item);
-    }
-
-    template <typename T>
-    void serialize(nonstd::span<T> vector) {
-        // Length prefix (standardized to u32)
-        serialize(static_cast<uint32_t>(vector.size()));
-        // Then serialize each member (possibly recursively, eg. if we have a vector of adjacency lists)
-        for (const T &item : vector)
-            serialize(item);
-    }
+    void write(const void *data, uint64_t size);
+    // Check which of the fast_header_t flags hold for the graph
+    uint32_t compute_flags() const;
 
   public:
-    Serializer(const Graph &, std::ostream &);
+    // num_threads is used to check the flags and compute the checksum
+    Serializer(const Graph &, std::ostream &, int num_threads);
 };
 
 #endif //GRAPH_COLORING_SERIALIZER_H
@@ -0,0 +1,319 @@
+#include "StreamingConverter.h"
+#include "../utils/MappedFile.h"
+#include "Dimacs10Parser.h"
+#include "DimacsParser.h"
+#include "FastFormat.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <unistd.h>
+
+// Size of the write buffer of each output section and run file (a multiple of 8 bytes, for fast_checksum)
+static const size_t WRITE_BUFFER_SIZE = 1 << 20;
+// Smallest read buffer given to each run in a merge; more runs than the budget allows are merged in several passes
+static const size_t MIN_READ_BUFFER_SIZE = 64 * 1024;
+// Largest number of runs merged at once, each of which holds a file descriptor, well below the usual limit of 1024
+static const size_t MAX_FAN_IN = 256;
+
+// Buffered writer for a section of the output file, starting at a given position, which also computes the checksum of
+// the section
+class StreamingConverter::SectionWriter {
+    std::fstream stream;
+    std::vector<uint8_t> buffer;
+    size_t used = 0;
+    // Index of the first word of the buffer in the data after the header
+    uint64_t word;
+
+  public:
+    uint64_t checksum = 0;
+
+    SectionWriter(const std::string &path, std::ios::openmode mode, uint64_t position)
+        : stream(path, mode | std::ios::out | std::ios::binary), buffer(WRITE_BUFFER_SIZE),
+          word((position - sizeof(fast_header_t)) / 8) {
+        if (!stream.is_open())
+            throw std::runtime_error("Failed to open FastParser file for writing.");
+        stream.seekp(std::streamoff(position));
+    }
+
+    void append(const void *data, size_t size) {
+        auto bytes = static_cast<const uint8_t *>(data);
+        while (size != 0) {
+            size_t chunk = std::min(size, buffer.size() - used);
+            std::memcpy(buffer.data() + used, bytes, chunk);
+            used += chunk;
+            bytes += chunk;
+            size -= chunk;
+            if (used == buffer.size())
+                flush();
+        }
+    }
+
+    // Only the last flush may write a partial word
+    void flush() {
+        checksum += fast_checksum(buffer.data(), used, word, 1);
+        word += used / 8;
+        stream.write(reinterpret_cast<const char *>(buffer.data()), std::streamsize(used));
+        used = 0;
+    }
+
+    void close() {
+        flush();
+        stream.close();
+        if (stream.fail())
+            throw std::runtime_error("Failed to write FastParser file.");
+    }
+};
+
+// Sequential reader of a run file, with a buffer of a given number of edges
+class RunReader {
+    std::ifstream stream;
+    std::vector<StreamingConverter::edge_t> buffer;
+    size_t position = 0, count = 0;
+
+  public:
+    RunReader(const std::string &path, size_t buffer_edges) : stream(path, std::ios::binary), buffer(buffer_edges) {
+        if (!stream.is_open())
+            throw std::runtime_error("Failed to open run file " + path);
+    }
+
+    bool next(StreamingConverter::edge_t &edge) {
+        if (position == count) {
+            stream.read(reinterpret_cast<char *>(buffer.data()), std::streamsize(buffer.size() * sizeof(edge)));
+            count = stream.gcount() / sizeof(edge);
+            position = 0;
+            if (count == 0)
+                return false;
+        }
+        edge = buffer[position++];
+        return true;
+    }
+};
+
+StreamingConverter::StreamingConverter(const std::string &input, const std::string &output, uint64_t memory_budget)
+    : input_path(input), output_path(output), temp_path(output + ".tmp" + std::to_string(getpid())),
+      memory_budget(memory_budget) {}
+
+StreamingConverter::~StreamingConverter() {
+    std::error_code ignored;
+    for (const auto &path : run_paths)
+        std::filesystem::remove(path, ignored);
+    // Only left if the conversion failed
+    std::filesystem::remove(temp_path, ignored);
+}
+
+void StreamingConverter::convert() {
+    MappedFile file(input_path);
+    const char *pos = reinterpret_cast<const char *>(file.data()), *end = pos + file.size();
+    auto extension = std::filesystem::path(input_path).extension();
+    Dimacs10Parser::format_t format;
+    if (extension == ".graph")
+        num_vertices = (format = Dimacs10Parser::parse_header(pos, end)).num_vertices;
+    else if (extension == ".gra")
+        num_vertices = DimacsParser::parse_header(pos, end);
+    else
+        throw std::runtime_error("Unrecognized extension: ." + extension.string());
+
+    fast_header_t header = {};
+    std::memcpy(header.magic, fast_header_t::MAGIC, sizeof(header.magic));
+    header.version = fast_header_t::VERSION;
+    header.byte_order = fast_header_t::BYTE_ORDER_MARK;
+    header.vertex_bits = GRAPH_VERTEX_BITS;
+    header.offset_bits = GRAPH_OFFSET_BITS;
+    header.num_vertices = num_vertices;
+
+    // A failed conversion must never leave a file without a header at the output path, which FastParser would take for
+    // an empty version 1 file, so write to a temporary one and rename it once complete. It is created by the first
+    // writer.
+    offsets = std::make_unique<SectionWriter>(temp_path, std::ios::trunc, header.offsets_position());
+    neighbors = std::make_unique<SectionWriter>(temp_path, std::ios::in, header.neighbors_position());
+    num_edges = rows_written = symmetry_difference = 0;
+    offset_t first_offset = 0;
+    offsets->append(&first_offset, sizeof(first_offset));
+
+    if (extension == ".graph")
+        convert_dimacs10(pos, end, format);
+    else
+        convert_dimacs(pos, end);
+    // Vertices without a line are isolated
+    while (rows_written < num_vertices)
+        end_row();
+
+    // Pad the offsets so that the neighbors start at a multiple of 8 bytes
+    static const char padding[8] = {};
+    offsets->append(padding, header.neighbors_position() - header.offsets_position() - (num_vertices + 1) * sizeof(offset_t));
+    offsets->close();
+    neighbors->close();
+
+    header.num_edges = num_edges;
+    // Rows are always sorted and deduplicated on the way
+    header.flags = fast_header_t::SORTED | fast_header_t::DEDUPLICATED;
+    if (symmetry_difference == 0)
+        header.flags |= fast_header_t::SYMMETRIC;
+    if (!self_loops)
+        header.flags |= fast_header_t::NO_SELF_LOOPS;
+    header.checksum = offsets->checksum + neighbors->checksum;
+    std::fstream header_stream(temp_path, std::ios::in | std::ios::out | std::ios::binary);
+    header_stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    header_stream.close();
+    if (header_stream.fail())
+        throw std::runtime_error("Failed to write FastParser file.");
+    std::filesystem::rename(temp_path, output_path);
+}
+
+void StreamingConverter::convert_dimacs10(const char *pos, const char *end, const Dimacs10Parser::format_t &format) {
+    adjacency_vec_t row;
+    Tokenizer::for_each_line(pos, end, [&](std::string_view line) {
+        // Lines after the last vertex are ignored, as in Dimacs10Parser
+        if (rows_written == num_vertices || Dimacs10Parser::is_comment(line))
+            return;
+        row.resize(Dimacs10Parser::count_numbers(line, format));
+        if (!Dimacs10Parser::parse_numbers(line, row, format))
+            throw std::runtime_error("Malformed line or invalid vertex ID in DIMACS-10 file");
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+        for (vertex_t neighbor : row)
+            append_neighbor(rows_written, neighbor);
+        end_row();
+    });
+}
+
+void StreamingConverter::convert_dimacs(const char *pos, const char *end) {
+    std::vector<edge_t> edges;
+    const size_t max_edges = std::max<uint64_t>(memory_budget / sizeof(edge_t), 2);
+    adjacency_vec_t row;
+    uint64_t vertex = 0;
+    Tokenizer::for_each_line(pos, end, [&](std::string_view line) {
+        if (vertex == num_vertices)
+            return;
+        row.clear();
+        if (!DimacsParser::parse_numbers(line, row, num_vertices))
+            throw std::runtime_error("Invalid vertex ID in DIMACS file");
+        // Each edge is listed once, so both directions are emitted
+        for (vertex_t neighbor : row) {
+            if (edges.size() + 2 > max_edges)
+                spill_run(edges);
+            // Grow the buffer as usual, but never past the budget
+            if (edges.size() + 2 > edges.capacity())
+                edges.reserve(std::min(std::max<size_t>(2 * edges.capacity(), 1024), max_edges));
+            edges.push_back({vertex_t(vertex), neighbor});
+            edges.push_back({neighbor, vertex_t(vertex)});
+        }
+        vertex++;
+    });
+
+    auto write_edge = [this, last = edge_t{}, first = true](const edge_t &edge) mutable {
+        // Runs are deduplicated, but the same edge may appear in several of them
+        if (!first && edge == last)
+            return;
+        while (rows_written < edge.from)
+            end_row();
+        append_neighbor(edge.from, edge.to);
+        last = edge;
+        first = false;
+    };
+
+    // A graph that fits in the buffer is written without going through run files
+    if (run_paths.empty()) {
+        std::sort(edges.begin(), edges.end());
+        for (const edge_t &edge : edges)
+            write_edge(edge);
+        return;
+    }
+    spill_run(edges);
+    // Release the buffer before the merge, whose read buffers take the memory budget
+    edges = {};
+
+    size_t max_fan_in = std::clamp<size_t>(memory_budget / MIN_READ_BUFFER_SIZE, 2, MAX_FAN_IN);
+    while (run_paths.size() > max_fan_in) {
+        // Merge the oldest runs into a new one
+        std::vector<std::string> group(run_paths.begin(), run_paths.begin() + max_fan_in);
+        std::string merged_path = output_path + ".run" + std::to_string(next_run++);
+        run_paths.push_back(merged_path);
+        {
+            std::ofstream merged(merged_path, std::ios::binary);
+            std::vector<edge_t> buffer;
+            buffer.reserve(WRITE_BUFFER_SIZE / sizeof(edge_t));
+            merge_runs(group, [&](const edge_t &edge) {
+                if (!buffer.empty() && buffer.back() == edge)
+                    return;
+                if (buffer.size() == buffer.capacity()) {
+                    merged.write(reinterpret_cast<const char *>(buffer.data()), std::streamsize(buffer.size() * sizeof(edge_t)));
+                    buffer.clear();
+                }
+                buffer.push_back(edge);
+            });
+            merged.write(reinterpret_cast<const char *>(buffer.data()), std::streamsize(buffer.size() * sizeof(edge_t)));
+            if (merged.fail())
+                throw std::runtime_error("Failed to write run file " + merged_path);
+        }
+        for (const auto &path : group)
+            std::filesystem::remove(path);
+        run_paths.erase(run_paths.begin(), run_paths.begin() + max_fan_in);
+    }
+
+    std::vector<std::string> final_runs = run_paths;
+    merge_runs(final_runs, write_edge);
+    for (const auto &path : final_runs)
+        std::filesystem::remove(path);
+    run_paths.clear();
+}
+
+void StreamingConverter::spill_run(std::vector<edge_t> &edges) {
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    std::string path = output_path + ".run" + std::to_string(next_run++);
+    run_paths.push_back(path);
+    num_runs++;
+    std::ofstream run(path, std::ios::binary);
+    run.write(reinterpret_cast<const char *>(edges.data()), std::streamsize(edges.size() * sizeof(edge_t)));
+    run.close();
+    if (run.fail())
+        throw std::runtime_error("Failed to write run file " + path);
+    edges.clear();
+}
+
+template <typename F>
+void StreamingConverter::merge_runs(const std::vector<std::string> &paths, F &&fn) {
+    size_t buffer_edges = std::max(memory_budget / paths.size(), uint64_t(MIN_READ_BUFFER_SIZE)) / sizeof(edge_t);
+    std::vector<RunReader> readers;
+    readers.reserve(paths.size());
+    for (const auto &path : paths)
+        readers.emplace_back(path, buffer_edges);
+
+    // Min-heap of the next edge of each run
+    using entry_t = std::pair<edge_t, size_t>;
+    std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> heap;
+    for (size_t idx = 0; idx < readers.size(); idx++) {
+        edge_t edge;
+        if (readers[idx].next(edge))
+            heap.emplace(edge, idx);
+    }
+    while (!heap.empty()) {
+        auto [edge, idx] = heap.top();
+        heap.pop();
+        fn(edge);
+        if (readers[idx].next(edge))
+            heap.emplace(edge, idx);
+    }
+}
+
+void StreamingConverter::append_neighbor(vertex_t from, vertex_t to) {
+    neighbors->append(&to, sizeof(to));
+    num_edges++;
+    symmetry_difference += fast_edge_hash(from, to) - fast_edge_hash(to, from);
+    self_loops |= from == to;
+}
+
+void StreamingConverter::end_row() {
+    if (num_edges > std::numeric_limits<offset_t>::max())
+        throw std::runtime_error("Too many edges for the configured offset width");
+    offset_t offset = num_edges;
+    offsets->append(&offset, sizeof(offset));
+    rows_written++;
+}
@@ -0,0 +1,73 @@
+#ifndef GRAPH_COLORING_STREAMINGCONVERTER_H
+#define GRAPH_COLORING_STREAMINGCONVERTER_H
+
+#include "../graph/Graph.h"
+#include "Dimacs10Parser.h"
+#include <compare>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* StreamingConverter converts a .gra or .graph file to a version 2 .fast file (see FastFormat.h) without building the
+ * graph in memory, so that graphs larger than RAM can be converted once and then mapped by FastParser.
+ *
+ * The input is mapped and read sequentially. The number of vertices in its header fixes the position of both arrays
+ * in the output, so the offsets and the neighbors are streamed into their sections of a temporary file as the rows are
+ * completed; the header (with the edge count, flags and checksum computed on the way) is written last, and the file is
+ * then renamed to the output path.
+ *
+ * DIMACS-10 files list the complete rows in vertex order, so each one is sorted and written straight through. DIMACS
+ * files list each edge once, so both directions of the edges are collected in a buffer of at most memory_budget bytes;
+ * whenever it fills up, it is sorted, deduplicated and spilled to a run file next to the output. The runs are then
+ * combined with a k-way merge (in several passes, if there are too many runs to give each a reasonable read buffer or
+ * to keep them all open at once) that produces the rows in order.
+ */
+class StreamingConverter {
+  public:
+    struct edge_t {
+        vertex_t from, to;
+        auto operator<=>(const edge_t &) const = default;
+    };
+
+  private:
+    class SectionWriter;
+
+    std::string input_path, output_path, temp_path;
+    uint64_t memory_budget;
+    // Run files that have not been removed yet
+    std::vector<std::string> run_paths;
+    uint64_t next_run = 0;
+
+    std::unique_ptr<SectionWriter> offsets, neighbors;
+    uint64_t rows_written = 0;
+    // Sum of fast_edge_hash(u, v) - fast_edge_hash(v, u) over the edges written, which is 0 if they are symmetric
+    uint64_t symmetry_difference = 0;
+    bool self_loops = false;
+
+    void convert_dimacs10(const char *pos, const char *end, const Dimacs10Parser::format_t &format);
+    void convert_dimacs(const char *pos, const char *end);
+
+    // Sort and deduplicate the edges, and write them to a new run file
+    void spill_run(std::vector<edge_t> &edges);
+    // Merge the run files, calling fn(edge) for each edge in increasing order
+    template <typename F>
+    void merge_runs(const std::vector<std::string> &paths, F &&fn);
+
+    void append_neighbor(vertex_t from, vertex_t to);
+    void end_row();
+
+  public:
+    // Statistics of the conversion
+    uint64_t num_vertices = 0, num_edges = 0;
+    uint64_t num_runs = 0;
+
+    // memory_budget bounds the size of the edge buffer and of the read buffers of the merge, in bytes
+    StreamingConverter(const std::string &input, const std::string &output, uint64_t memory_budget);
+    // Remove the run files and the partial output left by a failed conversion
+    ~StreamingConverter();
+
+    void convert();
+};
+
+#endif //GRAPH_COLORING_STREAMINGCONVERTER_H
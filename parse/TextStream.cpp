@@ -0,0 +1,85 @@
+#include "TextStream.h"
+#include "../utils/PCVector.h"
+#include "FastFormat.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+// Number of lines in text, counting a last line without a terminator
+static uint64_t count_lines(const std::string &text) {
+    uint64_t lines = std::count(text.begin(), text.end(), '\n');
+    return lines + (!text.empty() && text.back() != '\n');
+}
+
+TextStream::TextStream(const std::string &path, size_t block_size) : block_size(block_size) {
+    if (Decompressor::format_of(path) != Decompressor::NONE)
+        decompressor = std::make_unique<Decompressor>(path);
+    else {
+        reader = std::make_unique<BlockReader>(path, block_size);
+        read_stats.contents_checksum = 0;
+    }
+    read_block(first);
+}
+
+bool TextStream::is_streamed(const std::string &path, bool direct_io) {
+    return direct_io || Decompressor::format_of(path) != Decompressor::NONE;
+}
+
+bool TextStream::read_block(block_t &block) {
+    block.text = std::move(carry);
+    carry.clear();
+    while (true) {
+        size_t old_size = block.text.size();
+        block.text.resize(old_size + block_size);
+        char *buffer = block.text.data() + old_size;
+        size_t read = decompressor ? decompressor->read(buffer, block_size) : reader->read(buffer, block_size);
+        // BlockReader fills the buffer until the end of the file, so each read starts at a multiple of block_size
+        if (reader) {
+            *read_stats.contents_checksum += fast_checksum(reinterpret_cast<const uint8_t *>(buffer), read, read_stats.text_bytes / 8, 1);
+            read_stats.read_seconds = reader->busy();
+        }
+        read_stats.text_bytes += read;
+        block.text.resize(old_size + read);
+        if (read == 0)
+            break;
+        // Cut the block after its last line terminator; a line longer than a block makes the block grow
+        auto last_newline = static_cast<const char *>(memrchr(block.text.data() + old_size, '\n', read));
+        if (last_newline != nullptr) {
+            size_t cut = last_newline - block.text.data() + 1;
+            carry.assign(block.text, cut);
+            block.text.resize(cut);
+            break;
+        }
+    }
+    return !block.text.empty();
+}
+
+uint64_t TextStream::for_each_block(int num_threads, const std::function<void(const block_t &)> &fn) {
+    // Block the producer once a couple of blocks per thread are waiting, so that memory stays bounded when the parser
+    // threads are slower than decompression or I/O
+    PCVector<std::shared_ptr<const block_t>> queue(2 * static_cast<size_t>(num_threads));
+    queue.onReceive(num_threads, [&fn](std::shared_ptr<const block_t> block) { fn(*block); });
+
+    uint64_t num_blocks = 0, next_line = 0;
+    try {
+        auto block = std::make_shared<block_t>(std::move(first));
+        bool more = true;
+        while (more) {
+            block->first_line = next_line;
+            block->num_lines = count_lines(block->text);
+            block->index = num_blocks++;
+            next_line += block->num_lines;
+            queue.push(block);
+            block = std::make_shared<block_t>();
+            more = read_block(*block);
+        }
+    } catch (...) {
+        // Let the parser threads finish before reporting the error
+        queue.stop();
+        queue.join();
+        throw;
+    }
+    queue.stop();
+    queue.join();
+    return num_blocks;
+}
@@ -0,0 +1,77 @@
+#ifndef GRAPH_COLORING_TEXTSTREAM_H
+#define GRAPH_COLORING_TEXTSTREAM_H
+
+#include "../utils/BlockReader.h"
+#include "../utils/Decompressor.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+/* TextStream feeds the text parsers from a compressed file, or from an uncompressed one read with direct I/O, in
+ * blocks of whole lines.
+ *
+ * The calling thread decompresses (or reads, see BlockReader) the file block by block and hands each block over to a
+ * pool of parser threads through a PCVector, so that I/O, decompression and tokenization run in parallel and the text
+ * is never stored in full: each block is freed once parsed. Load time is thus bounded by decompression or device
+ * throughput as long as the parser threads keep up with it; if they do not, the queue is bounded (two blocks per
+ * thread), and decompression waits for them.
+ *
+ * Files read with direct I/O are hashed on the way, as CacheManager hashes its sources, so that their cache entry can
+ * be found without reading them again through the page cache.
+ */
+class TextStream {
+  public:
+    struct block_t {
+        std::string text;
+        // Number of the first line of the block, counted from the start of the first block (after the header was
+        // removed from it), and number of lines in the block
+        uint64_t first_line = 0, num_lines = 0;
+        // Position of the block in the file
+        uint64_t index = 0;
+    };
+
+    struct stats_t {
+        // Bytes of text read, after decompression
+        uint64_t text_bytes = 0;
+        // fast_checksum of the contents of a file read with direct I/O (see CacheManager::hash_contents)
+        std::optional<uint64_t> contents_checksum;
+        // Seconds during which reads of a file read with direct I/O were in flight (see BlockReader::busy), or 0
+        double read_seconds = 0;
+    };
+
+  private:
+    // Exactly one of them is set
+    std::unique_ptr<Decompressor> decompressor;
+    std::unique_ptr<BlockReader> reader;
+    size_t block_size;
+    block_t first;
+    // Start of a line that continues in the next block
+    std::string carry;
+    stats_t read_stats;
+
+    // Read the next block of whole lines into block.text; return false at the end of the file
+    bool read_block(block_t &block);
+
+  public:
+    // block_size must be a multiple of 8 bytes, for the checksum
+    TextStream(const std::string &path, size_t block_size = 4 << 20);
+
+    // Whether a file is parsed through a TextStream rather than mapped: compressed files always are, and uncompressed
+    // ones if direct I/O was requested
+    static bool is_streamed(const std::string &path, bool direct_io);
+
+    // The first block, read when the stream is opened. Parsers read the header from it and erase it, so that line
+    // numbers start from the first line after the header.
+    std::string &first_block() { return first.text; }
+
+    // Call fn(block) for each block (including the first one) on num_threads threads, in no particular order, while
+    // the calling thread decompresses the next blocks. Return the number of blocks.
+    uint64_t for_each_block(int num_threads, const std::function<void(const block_t &)> &fn);
+
+    // What was read so far, ie. the whole file once for_each_block returns
+    const stats_t &stats() const { return read_stats; }
+};
+
+#endif //GRAPH_COLORING_TEXTSTREAM_H
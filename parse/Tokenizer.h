@@ -0,0 +1,147 @@
+#ifndef GRAPH_COLORING_TOKENIZER_H
+#define GRAPH_COLORING_TOKENIZER_H
+
+#include "../utils/RangeSplitter.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Tokenizer for the text parsers: it reads whitespace-separated unsigned integers directly from a char buffer (eg. a
+ * mapped file), without copying lines or tokens into strings.
+ *
+ * With SSE2, 16 bytes are classified at a time: token starts are counted with a popcount over the separator mask, and
+ * the length of a number is found from the digit mask, so that the digits can then be converted without checking each
+ * character. Other targets use a scalar loop and std::from_chars.
+ *
+ * It also splits buffers into line-aligned chunks, so that parsers can process them in parallel.
+ */
+class Tokenizer {
+#if defined(__SSE2__)
+    // Bit i is set if byte i is a separator
+    static uint32_t separator_mask(__m128i chunk) {
+        __m128i separators = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+                                                       _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                                          _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')));
+        return _mm_movemask_epi8(separators);
+    }
+    // Bit i is set if byte i is a digit (bytes above 127 compare as negative, so they are not)
+    static uint32_t digit_mask(__m128i chunk) {
+        __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)),
+                                       _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1)));
+        return _mm_movemask_epi8(digits);
+    }
+#endif
+
+  public:
+    static bool is_separator(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    static const char *skip_separators(const char *pos, const char *end) {
+        while (pos < end && is_separator(*pos))
+            pos++;
+        return pos;
+    }
+
+    static const char *skip_token(const char *pos, const char *end) {
+        while (pos < end && !is_separator(*pos))
+            pos++;
+        return pos;
+    }
+
+    // Split [begin, end) in num_chunks byte ranges of about the same size, moving each boundary forward to the start of the
+    // following line. Chunk i is [boundaries[i], boundaries[i + 1]).
+    static std::vector<const char *> split_lines(const char *begin, const char *end, int num_chunks) {
+        std::vector<const char *> boundaries(num_chunks + 1, end);
+        boundaries[0] = begin;
+        RangeSplitter rs(end - begin, num_chunks);
+        for (int chunk = 1; chunk < num_chunks; chunk++) {
+            const char *boundary = std::max(begin + rs.get_min(chunk), boundaries[chunk - 1]);
+            if (boundary > begin && boundary < end && boundary[-1] != '\n') {
+                auto newline = static_cast<const char *>(std::memchr(boundary, '\n', end - boundary));
+                boundary = newline ? newline + 1 : end;
+            }
+            boundaries[chunk] = boundary;
+        }
+        return boundaries;
+    }
+
+    // Call fn(line) for each line in [begin, end), without the line terminator
+    template <typename F>
+    static void for_each_line(const char *begin, const char *end, F &&fn) {
+        while (begin < end) {
+            auto newline = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+            const char *line_end = newline ? newline : end;
+            fn(std::string_view(begin, line_end - begin));
+            begin = line_end + 1;
+        }
+    }
+
+    // Count the tokens in [begin, end)
+    static uint64_t count_tokens(const char *begin, const char *end) {
+        uint64_t count = 0;
+        bool after_separator = true;
+        const char *pos = begin;
+#if defined(__SSE2__)
+        for (; end - pos >= 16; pos += 16) {
+            uint32_t separators = separator_mask(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos)));
+            // A token starts at each non-separator that follows a separator
+            uint32_t follows_separator = (separators << 1) | uint32_t(after_separator);
+            count += std::popcount(~separators & follows_separator & 0xffff);
+            after_separator = separators >> 15;
+        }
+#endif
+        for (; pos < end; pos++) {
+            bool separator = is_separator(*pos);
+            count += after_separator && !separator;
+            after_separator = separator;
+        }
+        return count;
+    }
+
+    // Parse the unsigned integer starting at pos into value. Return the position after its last digit, or nullptr if
+    // there are no digits or the value does not fit in 64 bits.
+    static const char *parse_uint(const char *pos, const char *end, uint64_t &value) {
+#if defined(__SSE2__)
+        if (end - pos >= 16) {
+            int length = std::countr_one(digit_mask(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))));
+            if (length == 0)
+                return nullptr;
+            // Up to 15 digits always fit in 64 bits, and the loop has no data-dependent branches
+            if (length < 16) {
+                value = 0;
+                for (int idx = 0; idx < length; idx++)
+                    value = value * 10 + uint64_t(pos[idx] - '0');
+                return pos + length;
+            }
+        }
+#endif
+        auto result = std::from_chars(pos, end, value);
+        return result.ec == std::errc() ? result.ptr : nullptr;
+    }
+
+    // Parse consecutive integer tokens starting at pos, calling fn(value) for each one. Stop at the end of the buffer or
+    // at the first token that is not a number, and return its position.
+    template <typename F>
+    static const char *parse_uints(const char *pos, const char *end, F &&fn) {
+        pos = skip_separators(pos, end);
+        while (pos < end) {
+            uint64_t value;
+            const char *next = parse_uint(pos, end, value);
+            if (next == nullptr || (next < end && !is_separator(*next)))
+                return pos;
+            fn(value);
+            pos = skip_separators(next, end);
+        }
+        return pos;
+    }
+};
+
+#endif //GRAPH_COLORING_TOKENIZER_H
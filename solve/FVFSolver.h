@@ -6,16 +6,19 @@
 class FVFSolver : public Solver {
     uint32_t num_threads;
 
-    std::vector<uint32_t> wrong_ones;
-
-    void coloring_in_parallel(uint32_t from, uint32_t to, Graph &graph);
+    template <typename G>
+    void solve_impl(const G &, Coloring &);
+    template <typename G>
+    void coloring_in_parallel(vertex_t from, vertex_t to, const G &graph, Coloring &coloring, std::vector<vertex_t> &wrong_ones);
 
   public:
     FVFSolver(int num_threads);
 
     std::string name() const;
 
-    void solve(Graph &);
+    void solve(const Graph &, Coloring &);
+    bool supports_compressed() const { return true; }
+    void solve(const CompressedGraph &, Coloring &);
 };
 
 #endif //GRAPH_COLORING_FVFSOLVER_H
\ No newline at end of file
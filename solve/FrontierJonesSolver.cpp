@@ -0,0 +1,74 @@
+#include "FrontierJonesSolver.h"
+#include "../utils/RangeSplitter.h"
+#include <algorithm>
+#include <numeric>
+
+FrontierJonesSolver::FrontierJonesSolver(int num_threads) : num_threads(num_threads), gen(RANDOM_SEED) {}
+
+std::string FrontierJonesSolver::name() const {
+    return "FrontierJonesSolver (" + std::to_string(num_threads) + " threads)";
+}
+
+std::string FrontierJonesSolver::details() const {
+    std::string sizes;
+    for (uint64_t size : frontier_sizes)
+        sizes += (sizes.empty() ? "" : " ") + std::to_string(size);
+    return std::to_string(frontier_sizes.size()) + " rounds, frontier sizes: " + sizes;
+}
+
+void FrontierJonesSolver::solve(const Graph &graph, Coloring &coloring) {
+    solve_impl(graph, coloring);
+}
+
+void FrontierJonesSolver::solve(const CompressedGraph &graph, Coloring &coloring) {
+    solve_impl(graph, coloring);
+}
+
+template <typename G>
+void FrontierJonesSolver::solve_impl(const G &graph, Coloring &coloring) {
+    // The same priorities as JonesSolver, so that the two can be compared
+    std::vector<vertex_t> rho(graph.num_vertices());
+    std::iota(rho.begin() + 1, rho.end(), 1);
+    std::shuffle(rho.begin(), rho.end(), gen);
+
+    std::vector<vertex_t> frontier(graph.num_vertices());
+    parallel_for(graph.num_vertices(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; vertex++) {
+            frontier[vertex] = vertex;
+            coloring.set_color(vertex, Coloring::UNCOLORED);
+        }
+    });
+
+    // Per-thread lists of the vertices selected in a round, and of those left for the next one
+    std::vector<std::vector<vertex_t>> selected(num_threads), remaining(num_threads);
+    frontier_sizes.clear();
+    while (!frontier.empty()) {
+        frontier_sizes.push_back(frontier.size());
+        parallel_for(frontier.size(), num_threads, [&](int thread_idx, uint64_t from, uint64_t to) {
+            selected[thread_idx].clear();
+            remaining[thread_idx].clear();
+            for (uint64_t i = from; i < to; i++) {
+                vertex_t vertex = frontier[i];
+                bool is_maximum = true;
+                for (vertex_t neighbor : graph.neighbors_of(vertex))
+                    if (neighbor != vertex && rho[neighbor] > rho[vertex] && coloring.color_of(neighbor) == Coloring::UNCOLORED) {
+                        is_maximum = false;
+                        break;
+                    }
+                (is_maximum ? selected : remaining)[thread_idx].push_back(vertex);
+            }
+        });
+        // The parts left by each thread are copied back into the frontier, which is no longer read, at offsets given
+        // by a prefix sum of their sizes: each thread's part starts before the range it read, so no copy overwrites
+        // another. Colors are only written once all threads are done reading them to select vertices.
+        std::vector<uint64_t> offsets(num_threads + 1, 0);
+        for (int thread_idx = 0; thread_idx < num_threads; thread_idx++)
+            offsets[thread_idx + 1] = offsets[thread_idx] + remaining[thread_idx].size();
+        parallel_for(num_threads, num_threads, [&](int thread_idx, uint64_t, uint64_t) {
+            for (vertex_t vertex : selected[thread_idx])
+                coloring.color_with_smallest(graph, vertex);
+            std::copy(remaining[thread_idx].begin(), remaining[thread_idx].end(), frontier.begin() + offsets[thread_idx]);
+        });
+        frontier.resize(offsets[num_threads]);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef GRAPH_COLORING_FRONTIERJONESSOLVER_H
+#define GRAPH_COLORING_FRONTIERJONESSOLVER_H
+
+#include "Solver.h"
+#include <random>
+#include <vector>
+
+/* FrontierJonesSolver is a bulk-synchronous variant of Jones-Plassmann (see JonesSolver). The uncolored vertices form a
+ * frontier, and each round:
+ *  - finds in parallel the vertices of the frontier whose rho is larger than that of all their uncolored neighbors;
+ *  - colors all of them with first-fit, which is safe since no two of them are neighbors;
+ *  - compacts the rest of the frontier for the next round, each thread copying its part at an offset given by a prefix
+ *    sum of the parts' sizes.
+ *
+ * Uncolored vertices hold Coloring::UNCOLORED, which first-fit ignores, so the color of each vertex only depends on
+ * the rounds before its own. The result is thus the same for a given seed whatever the number of threads, and no locks
+ * or atomic read-modify-writes are needed: threads only meet at the end of each phase.
+ */
+class FrontierJonesSolver : public Solver {
+    int num_threads;
+    std::mt19937 gen;
+    // Size of the frontier at the start of each round of the last run
+    std::vector<uint64_t> frontier_sizes;
+
+    template <typename G>
+    void solve_impl(const G &, Coloring &);
+
+  public:
+    FrontierJonesSolver(int num_threads = 1);
+
+    std::string name() const;
+    std::string details() const;
+    std::vector<uint64_t> round_sizes() const { return frontier_sizes; }
+
+    void solve(const Graph &, Coloring &);
+    bool supports_compressed() const { return true; }
+    void solve(const CompressedGraph &, Coloring &);
+};
+
+#endif //GRAPH_COLORING_FRONTIERJONESSOLVER_H
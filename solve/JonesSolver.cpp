@@ -1,4 +1,7 @@
 #include "JonesSolver.h"
+#include "../utils/RangeSplitter.h"
+#include <numeric>
+#include <vector>
 
 JonesSolver::JonesSolver(int num_threads) : num_threads(num_threads), gen(RANDOM_SEED) {}
 
@@ -6,49 +9,79 @@ std::string JonesSolver::name() const {
     return "JonesSolver (" + std::to_string(num_threads) + " threads)";
 }
 
-void JonesSolver::solve(Graph &graph) {
-    std::vector<uint32_t> rho(graph.num_vertices());
+void JonesSolver::solve(const Graph &graph, Coloring &coloring) {
+    solve_impl(graph, coloring);
+}
+
+void JonesSolver::solve(const CompressedGraph &graph, Coloring &coloring) {
+    solve_impl(graph, coloring);
+}
+
+template <typename G>
+void JonesSolver::solve_impl(const G &graph, Coloring &coloring) {
+    std::vector<vertex_t> rho(graph.num_vertices());
     // In Jones' paper, "choose rho(v)" = generate a different random number for each vertex
     std::iota(rho.begin() + 1, rho.end(), 1);
     std::shuffle(rho.begin(), rho.end(), gen);
 
-    PCVector<uint32_t> free_vertices;
-    std::atomic<uint32_t> num_vertices_uncolored = graph.num_vertices();
+    // Free vertices (those that can be colored) are kept in one work-stealing deque per thread: a thread pushes the
+    // vertices it frees to its own deque and pops the newest one, whose neighborhood is still in its cache, and only
+    // steals (the oldest vertices) from the others when its deque is empty
+    std::vector<WorkStealingDeque<vertex_t>> free_vertices(num_threads);
+    std::atomic<vertex_t> num_vertices_uncolored = graph.num_vertices();
 
     // Associates each vertex with the number of neighbors it is "waiting on" (uncolored with higher rho)
     std::vector<std::atomic<int>> waitlist(graph.num_vertices());
-    for (uint32_t vertex = 0; vertex < graph.num_vertices(); ++vertex) {
-        const auto &neighbors = graph.neighbors_of(vertex);
-        auto rho_current = rho[vertex];
-        int num_wait = 0;
-        for (const auto neighbor : graph.neighbors_of(vertex))
-            if (rho[neighbor] > rho_current)
-                num_wait++;
-        waitlist[vertex] = num_wait;
-        if (num_wait == 0)
-            free_vertices.push(vertex);
-    }
-
-    free_vertices.onReceive(num_threads, [&free_vertices, &num_vertices_uncolored, &graph, &waitlist, &rho](uint32_t vertex) {
-        // Check if there are no vertices left to color
-        if (--num_vertices_uncolored == 0)
-            // If so, tell all threads not to wait for more free vertices
-            free_vertices.stop();
-
-        // Color the current node...
-        graph.color_with_smallest(vertex);
-        // And update any neighbor that may be "waiting" on it
-        for (uint32_t neighbor : graph.neighbors_of(vertex)) {
-            // If it is no longer waiting on anything, push it to the free vertices queue
-            if (rho[vertex] > rho[neighbor] && --waitlist[neighbor] == 0)
-                free_vertices.push(neighbor);
+    parallel_for(graph.num_vertices(), num_threads, [&](int thread_idx, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; ++vertex) {
+            auto rho_current = rho[vertex];
+            int num_wait = 0;
+            for (const auto neighbor : graph.neighbors_of(vertex))
+                if (rho[neighbor] > rho_current)
+                    num_wait++;
+            waitlist[vertex].store(num_wait, std::memory_order_relaxed);
+            // Threads are joined before coloring starts, so the deques can be filled from these threads
+            if (num_wait == 0)
+                free_vertices[thread_idx].push(vertex);
         }
-        /*
-        // Deadlock detection
-        if (num_threads == 1 && free_vertices.empty() && num_vertices_uncolored != 0)
-            raise(SIGTRAP);
-        */
     });
 
-    free_vertices.join();
+    parallel_for(num_threads, num_threads, [&](int thread_idx, uint64_t, uint64_t) {
+        WorkStealingDeque<vertex_t> &own = free_vertices[thread_idx];
+        // Try the other deques in turn, starting from the next thread's
+        auto steal = [&](vertex_t &vertex) {
+            for (int offset = 1; offset < num_threads; offset++)
+                if (free_vertices[(thread_idx + offset) % num_threads].steal(vertex))
+                    return true;
+            return false;
+        };
+
+        vertex_t vertex, next;
+        // The first neighbor freed by a vertex is colored next without going through the deque
+        bool has_next = false;
+        while (num_vertices_uncolored.load(std::memory_order_acquire) != 0) {
+            if (has_next) {
+                vertex = next;
+                has_next = false;
+            } else if (!own.pop(vertex) && !steal(vertex)) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Color the current node...
+            coloring.color_with_smallest(graph, vertex);
+            // And update any neighbor that may be "waiting" on it. The decrement publishes the color to the thread
+            // that frees the neighbor.
+            for (vertex_t neighbor : graph.neighbors_of(vertex)) {
+                if (rho[vertex] > rho[neighbor] && --waitlist[neighbor] == 0) {
+                    if (has_next)
+                        own.push(neighbor);
+                    else {
+                        next = neighbor;
+                        has_next = true;
+                    }
+                }
+            }
+            num_vertices_uncolored.fetch_sub(1, std::memory_order_release);
+        }
+    });
 }
@@ -1,11 +1,9 @@
 #ifndef GRAPH_COLORING_JONESSOLVER_H
 #define GRAPH_COLORING_JONESSOLVER_H
 
-#include "../utils/PCVector.h"
+#include "../utils/WorkStealingDeque.h"
 #include "Solver.h"
 #include <atomic>
-#include <functional>
-#include <map>
 #include <random>
 #include <thread>
 
@@ -13,12 +11,17 @@ class JonesSolver : public Solver {
     int num_threads;
     std::mt19937 gen;
 
+    template <typename G>
+    void solve_impl(const G &, Coloring &);
+
   public:
     JonesSolver(int num_threads = 1);
 
     std::string name() const;
 
-    void solve(Graph &);
+    void solve(const Graph &, Coloring &);
+    bool supports_compressed() const { return true; }
+    void solve(const CompressedGraph &, Coloring &);
 };
 
 #endif //GRAPH_COLORING_JONESSOLVER_H
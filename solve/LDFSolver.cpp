@@ -1,11 +1,13 @@
 #include "LDFSolver.h"
 #include "../utils/RangeSplitter.h"
+#include <algorithm>
+#include <atomic>
 #include <numeric>
 #include <thread>
 
 LDFSolver::LDFSolver(int num_threads) : num_threads(num_threads) {}
 
-void LDFSolver::solve(Graph &graph) {
+void LDFSolver::solve(const Graph &graph, Coloring &coloring) {
     /* if a number of threads larger than the ability of the system, generate error */
     if (num_threads > std::thread::hardware_concurrency())
         throw std::runtime_error("Hardware concurrency exceeded: please use at most " + std::to_string(std::thread::hardware_concurrency()) + " threads");
@@ -13,41 +15,48 @@ void LDFSolver::solve(Graph &graph) {
     /* Each thread has a vertex to start from and a range of vertices to work on */
     RangeSplitter rs(graph.num_vertices(), num_threads);
 
+    /* Each thread records the vertices it may have miscolored in its own buffer, so no locking is needed */
+    std::vector<std::vector<vertex_t>> wrong_ones(num_threads);
+
     std::vector<std::thread> threads;
 
     for (int thread_idx = 0; thread_idx < num_threads; thread_idx++)
-        threads.emplace_back(std::thread([thread_idx, &graph, this, rs]() {
-            uint32_t from = rs.get_min(thread_idx), to = rs.get_max(thread_idx);
+        threads.emplace_back(std::thread([thread_idx, &graph, &coloring, &wrong_ones, this, rs]() {
+            vertex_t from = rs.get_min(thread_idx), to = rs.get_max(thread_idx);
 
             /* Applying the coloring phase where coloring is done in order according to the assigned weights */
-            coloring_in_parallel(from, to, graph);
+            coloring_in_parallel(from, to, graph, coloring, wrong_ones[thread_idx]);
         }));
 
     for (auto &th : threads) {
         th.join();
     }
 
-    for (const auto &vertex : wrong_ones) {
-        graph.color_with_smallest(vertex);
-    }
+    /* Recolor the vertices with conflicts sequentially, reading each thread's buffer in turn */
+    for (const auto &partial_wrong_ones : wrong_ones)
+        for (const auto &vertex : partial_wrong_ones)
+            coloring.color_with_smallest(graph, vertex);
 }
 
-void LDFSolver::coloring_in_parallel(uint32_t from, uint32_t to, Graph &graph) {
+void LDFSolver::coloring_in_parallel(vertex_t from, vertex_t to, const Graph &graph, Coloring &coloring, std::vector<vertex_t> &wrong_ones) {
 
     /* Create a vector to represent the vertices to be colored in order and initialize it in ascending order */
-    std::vector<uint32_t> vertices_to_color(to - from);
+    std::vector<vertex_t> vertices_to_color(to - from);
     std::iota(vertices_to_color.begin(), vertices_to_color.end(), from);
 
     /* Sort the vector by degree */
-    std::stable_sort(vertices_to_color.begin(), vertices_to_color.end(), [&](int i, int j) {
+    std::stable_sort(vertices_to_color.begin(), vertices_to_color.end(), [&](vertex_t i, vertex_t j) {
         return graph.degree_of(i) > graph.degree_of(j);
     });
 
     /* start coloring according to the order assigned above where no two neighbors have the same color */
     for (const auto &vertex_to_color : vertices_to_color) {
-        uint32_t my_color = graph.color_with_smallest(vertex_to_color);
+        uint32_t my_color = coloring.color_with_smallest(graph, vertex_to_color);
+        // Order the store of my_color before the reads below: if a neighbor is being colored at the same time, at
+        // least one of the two threads then sees the other's color and records the conflict
+        std::atomic_thread_fence(std::memory_order_seq_cst);
         for (const auto &neighbor : graph.neighbors_of(vertex_to_color)) {
-            if (my_color == graph.color_of(neighbor)) {
+            if (my_color == coloring.color_of(neighbor)) {
                 wrong_ones.emplace_back(vertex_to_color);
                 break;
             }
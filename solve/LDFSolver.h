@@ -7,16 +7,14 @@ class LDFSolver : public Solver {
 
     uint32_t num_threads;
 
-    std::vector<uint32_t> wrong_ones;
-
-    void coloring_in_parallel(uint32_t from, uint32_t to, Graph &graph);
+    void coloring_in_parallel(vertex_t from, vertex_t to, const Graph &graph, Coloring &coloring, std::vector<vertex_t> &wrong_ones);
 
   public:
     LDFSolver(int num_threads);
 
     std::string name() const;
 
-    void solve(Graph &);
+    void solve(const Graph &, Coloring &);
 };
 
 #endif //GRAPH_COLORING_LDFSOLVER_H
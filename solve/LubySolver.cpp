@@ -1,7 +1,9 @@
 #include "LubySolver.h"
 
 LubySolver::LubySolver(int num_threads) : num_threads(num_threads), partial_S(num_threads), kill_threads(false),
-                                          V_splitter(nullptr), gen(RANDOM_SEED) {
+                                          V_splitter(nullptr) {
+    for (int thread_idx = 0; thread_idx < num_threads; thread_idx++)
+        gens.emplace_back(RANDOM_SEED + thread_idx);
     pthread_barrier_init(&thread_start_barrier, nullptr, num_threads + 1);
     pthread_barrier_init(&thread_end_barrier, nullptr, num_threads + 1);
 }
@@ -12,7 +14,7 @@ LubySolver::~LubySolver() {
     delete V_splitter;
 }
 
-void LubySolver::solve(Graph &original_graph) {
+void LubySolver::solve(const Graph &original_graph, Coloring &coloring) {
     DeletableGraph uncolored_graph(original_graph);
 
     // We create the threads here, but they are only "activated" by the barrier in probabilistic_select.
@@ -30,10 +32,10 @@ void LubySolver::solve(Graph &original_graph) {
                     // Select at least one item from V
                     while (S.empty()) {
                         // Include each vertex with probability 1/(2/d(v))
-                        for (uint32_t vertex : partial_V) {
+                        for (vertex_t vertex : partial_V) {
                             double probability = 1. / (2 * graph.degree_of(vertex));
                             std::bernoulli_distribution d(probability);
-                            if (d(gen)) {
+                            if (d(gens[thread_idx])) {
                                 S.push_back(vertex);
                                 S_bitmap[vertex] = true;
                             }
@@ -49,8 +51,8 @@ void LubySolver::solve(Graph &original_graph) {
     color_t color = 0;
     while (!uncolored_graph.empty()) {
         compute_MIS(uncolored_graph);
-        for (uint32_t vertex : MIS) {
-            original_graph.colors[vertex] = color;
+        for (vertex_t vertex : MIS) {
+            coloring.set_color(vertex, color);
             uncolored_graph.delete_vertex(vertex);
         }
         color++;
@@ -64,17 +66,17 @@ void LubySolver::solve(Graph &original_graph) {
 
 // Best explained here:
 // https://en.wikipedia.org/wiki/Maximal_independent_set#Random-selection_parallel_algorithm_[Luby's_Algorithm]
-void LubySolver::compute_MIS(const DeletableGraph &del_graph) {
+void LubySolver::compute_MIS(DeletableGraph &del_graph) {
     // Reset solver state
     MIS.clear();
     V.clear();
 
     const Graph &graph = del_graph.graph;
 
-    for (uint32_t i = 0; i < graph.num_vertices(); i++)
-        // It suffices to check for is_deleted here, since we don't delete vertices inside the function
-        if (!del_graph.is_deleted(i))
-            V.emplace(i);
+    // It suffices to check for deleted vertices here, since we don't delete vertices inside the function.
+    // The list of remaining vertices is sorted, so each insertion happens at the end of the set.
+    for (vertex_t v : del_graph.remaining_vertices())
+        V.emplace_hint(V.end(), v);
 
     while (!V.empty()) {
         // The subset of vertices selected
@@ -83,12 +85,12 @@ void LubySolver::compute_MIS(const DeletableGraph &del_graph) {
 
         remove_edges(graph);
 
-        for (uint32_t v : S) {
+        for (vertex_t v : S) {
             if (!S_bitmap[v])
                 continue;
             MIS.emplace_back(v);
             V.erase(v);
-            for (uint32_t neighbor : graph.neighbors_of(v))
+            for (vertex_t neighbor : graph.neighbors_of(v))
                 V.erase(neighbor);
         }
     }
@@ -102,7 +104,7 @@ void LubySolver::probabilistic_select(const Graph &graph) {
     for (auto &S_ : partial_S)
         S_.clear();
     // Mirror V into a temporary vector
-    V_vec = std::move(std::vector<uint32_t>(V.cbegin(), V.cend()));
+    V_vec = std::move(std::vector<vertex_t>(V.cbegin(), V.cend()));
     if (V_splitter != nullptr)
         delete V_splitter;
     V_splitter = new VectorSplitter(V_vec, num_threads);
@@ -124,16 +126,16 @@ void LubySolver::remove_edges(const Graph &g) {
     // Specification: "For each edge in E, check if 'from' and 'to' are in the graph S.".
     // We can loop on fewer items by checking "for each edge in S, check if 'from' and 'to' are in E."
 
-    for (uint32_t from : S) {
+    for (vertex_t from : S) {
         /* Equivalent to:
          *
-         *   for (uint32_t to : g.neighbors_of(from))
+         *   for (vertex_t to : g.neighbors_of(from))
          *
          * However, since neighbors are sorted we can start searching in the middle of the array, after the smaller vertices.
          */
         auto neighbors = g.neighbors_of(from);
         for (auto pos = std::lower_bound(neighbors.begin(), neighbors.end(), from); pos != neighbors.end(); ++pos) {
-            uint32_t to = *pos;
+            vertex_t to = *pos;
             if (!S_bitmap[to])
                 continue;
             if (g.degree_of(from) <= g.degree_of(to))
@@ -9,18 +9,19 @@
 
 class LubySolver : public Solver {
     int num_threads;
-    std::mt19937 gen;
+    // One generator per thread, as std::mt19937 is not thread-safe
+    std::vector<std::mt19937> gens;
     std::vector<std::thread> threads;
-    std::vector<uint32_t> MIS;
+    std::vector<vertex_t> MIS;
 
     // Variables for probabilistic_select
-    std::vector<uint32_t> S;
+    std::vector<vertex_t> S;
     std::vector<char> S_bitmap;
-    std::vector<std::vector<uint32_t>> partial_S;
-    std::set<uint32_t> V;
+    std::vector<std::vector<vertex_t>> partial_S;
+    std::set<vertex_t> V;
     // Mirrors V into a vector so that each thread can work on part of it using V_splitter
-    std::vector<uint32_t> V_vec;
-    VectorSplitter<uint32_t> *V_splitter;
+    std::vector<vertex_t> V_vec;
+    VectorSplitter<vertex_t> *V_splitter;
 
     bool kill_threads;
     pthread_barrier_t thread_start_barrier, thread_end_barrier;
@@ -30,7 +31,7 @@ class LubySolver : public Solver {
     // Second step
     inline void remove_edges(const Graph &);
     // Luby's algorithm
-    void compute_MIS(const DeletableGraph &src);
+    void compute_MIS(DeletableGraph &src);
 
   public:
     LubySolver(int num_threads = 1);
@@ -38,7 +39,7 @@ class LubySolver : public Solver {
 
     std::string name() const;
 
-    void solve(Graph &);
+    void solve(const Graph &, Coloring &);
 };
 
 #endif //GRAPH_COLORING_LUBYSOLVER_H
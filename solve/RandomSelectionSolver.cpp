@@ -1,11 +1,16 @@
 #include "RandomSelectionSolver.h"
 #include "../utils/RangeSplitter.h"
+#include <algorithm>
+#include <atomic>
 #include <numeric>
 #include <thread>
 
-RandomSelectionSolver::RandomSelectionSolver(int num_threads) : num_threads(num_threads), random_gen(RANDOM_SEED) {}
+RandomSelectionSolver::RandomSelectionSolver(int num_threads) : num_threads(num_threads) {
+    for (int thread_idx = 0; thread_idx < num_threads; thread_idx++)
+        random_gens.emplace_back(RANDOM_SEED + thread_idx);
+}
 
-void RandomSelectionSolver::solve(Graph &graph) {
+void RandomSelectionSolver::solve(const Graph &graph, Coloring &coloring) {
     /* if a number of threads larger than the ability of the system, generate error */
     if (num_threads > std::thread::hardware_concurrency())
         throw std::runtime_error("Hardware concurrency exceeded: please use at most " +
@@ -14,36 +19,43 @@ void RandomSelectionSolver::solve(Graph &graph) {
     /* Each thread has a vertex to start from and a range of vertices to work on */
     RangeSplitter rs(graph.num_vertices(), num_threads);
 
+    /* Each thread records the vertices it may have miscolored in its own buffer, so no locking is needed */
+    std::vector<std::vector<vertex_t>> wrong_ones(num_threads);
+
     std::vector<std::thread> threads;
 
     for (int thread_idx = 0; thread_idx < num_threads; thread_idx++)
-        threads.emplace_back(std::thread([thread_idx, &graph, this, rs]() {
-            uint32_t from = rs.get_min(thread_idx), to = rs.get_max(thread_idx);
+        threads.emplace_back(std::thread([thread_idx, &graph, &coloring, &wrong_ones, this, rs]() {
+            vertex_t from = rs.get_min(thread_idx), to = rs.get_max(thread_idx);
 
             /* Applying the coloring phase where coloring is done in order according to the assigned weights */
-            coloring_in_parallel(from, to, graph);
+            coloring_in_parallel(from, to, graph, coloring, wrong_ones[thread_idx], random_gens[thread_idx]);
         }));
 
     for (auto &th : threads) {
         th.join();
     }
 
-    for (const auto &vertex : wrong_ones) {
-        graph.color_with_smallest(vertex);
-    }
+    /* Recolor the vertices with conflicts sequentially, reading each thread's buffer in turn */
+    for (const auto &partial_wrong_ones : wrong_ones)
+        for (const auto &vertex : partial_wrong_ones)
+            coloring.color_with_smallest(graph, vertex);
 }
 
-void RandomSelectionSolver::coloring_in_parallel(uint32_t from, uint32_t to, Graph &graph) {
-    std::vector<uint32_t> random_order(to - from);
+void RandomSelectionSolver::coloring_in_parallel(vertex_t from, vertex_t to, const Graph &graph, Coloring &coloring, std::vector<vertex_t> &wrong_ones, std::mt19937 &random_gen) {
+    std::vector<vertex_t> random_order(to - from);
 
     std::iota(random_order.begin(), random_order.end(), from);
     std::shuffle(random_order.begin(), random_order.end(), random_gen);
 
     /* start coloring according to the order assigned above where no two neighbors have the same color */
     for (const auto &vertex_to_color : random_order) {
-        uint32_t my_color = graph.color_with_smallest(vertex_to_color);
+        uint32_t my_color = coloring.color_with_smallest(graph, vertex_to_color);
+        // Order the store of my_color before the reads below: if a neighbor is being colored at the same time, at
+        // least one of the two threads then sees the other's color and records the conflict
+        std::atomic_thread_fence(std::memory_order_seq_cst);
         for (const auto &neighbor : graph.neighbors_of(vertex_to_color)) {
-            if (my_color == graph.color_of(neighbor)) {
+            if (my_color == coloring.color_of(neighbor)) {
                 wrong_ones.emplace_back(vertex_to_color);
                 break;
             }
@@ -6,18 +6,17 @@
 
 class RandomSelectionSolver : public Solver {
     uint32_t num_threads;
-    std::mt19937 random_gen;
+    // One generator per thread, as std::mt19937 is not thread-safe
+    std::vector<std::mt19937> random_gens;
 
-    std::vector<uint32_t> wrong_ones;
-
-    void coloring_in_parallel(uint32_t from, uint32_t to, Graph &graph);
+    void coloring_in_parallel(vertex_t from, vertex_t to, const Graph &graph, Coloring &coloring, std::vector<vertex_t> &wrong_ones, std::mt19937 &random_gen);
 
   public:
     RandomSelectionSolver(int num_threads);
 
     std::string name() const;
 
-    void solve(Graph &);
+    void solve(const Graph &, Coloring &);
 };
 
 #endif //GRAPH_COLORING_RANDOMSELECTIONSOLVER_H
\ No newline at end of file
@@ -3,11 +3,12 @@
 
 SDLSolver::SDLSolver(int num_threads) : num_threads(num_threads) {}
 
-void SDLSolver::solve(Graph &graph) {
+void SDLSolver::solve(const Graph &graph, Coloring &coloring) {
 
-    uint32_t num_vertices = graph.num_vertices();
+    vertex_t num_vertices = graph.num_vertices();
 
-    std::vector<uint32_t> degrees(num_vertices, 0);
+    // Threads decrement the degrees of neighbors outside of their range, so degrees must be atomic
+    std::vector<std::atomic<uint32_t>> degrees(num_vertices);
     std::vector<uint32_t> weights(num_vertices, 0);
 
     /* if a number of threads larger than the ability of the system, generate error */
@@ -17,17 +18,20 @@ void SDLSolver::solve(Graph &graph) {
     /* Each thread has a vertex to start from and a range of vertices to work on */
     RangeSplitter rs(num_vertices, num_threads);
 
+    /* Each thread records the vertices it may have miscolored in its own buffer, so no locking is needed */
+    std::vector<std::vector<vertex_t>> wrong_ones(num_threads);
+
     std::vector<std::thread> threads;
 
     for (int thread_idx = 0; thread_idx < num_threads; thread_idx++) {
-        threads.emplace_back(std::thread([&graph, &weights, &degrees, this, rs, thread_idx]() {
-            uint32_t from = rs.get_min(thread_idx), to = rs.get_max(thread_idx);
+        threads.emplace_back(std::thread([&graph, &coloring, &weights, &degrees, &wrong_ones, this, rs, thread_idx]() {
+            vertex_t from = rs.get_min(thread_idx), to = rs.get_max(thread_idx);
 
             /* Applying the weighting phase where each vertex takes a weight according to a particular algorithm */
             apply_weighting_phase(graph, degrees, weights, from, to);
 
             /* Applying the coloring phase where coloring is done in order according to the assigned weights */
-            apply_coloring_phase(degrees, from, to, graph);
+            apply_coloring_phase(weights, from, to, graph, coloring, wrong_ones[thread_idx]);
         }));
     }
 
@@ -35,22 +39,23 @@ void SDLSolver::solve(Graph &graph) {
         th.join();
     }
 
-    for (const auto &vertex : wrong_ones) {
-        graph.color_with_smallest(vertex);
-    }
+    /* Recolor the vertices with conflicts sequentially, reading each thread's buffer in turn */
+    for (const auto &partial_wrong_ones : wrong_ones)
+        for (const auto &vertex : partial_wrong_ones)
+            coloring.color_with_smallest(graph, vertex);
 }
 
-void SDLSolver::apply_weighting_phase(const Graph &graph, std::vector<uint32_t> &degrees, std::vector<uint32_t> &weights, uint32_t from, uint32_t to) {
+void SDLSolver::apply_weighting_phase(const Graph &graph, std::vector<std::atomic<uint32_t>> &degrees, std::vector<uint32_t> &weights, vertex_t from, vertex_t to) {
 
     /*Each from computes its degree and announcing it by saving it in a shared vector */
-    for (uint32_t vertexID = from; vertexID < to; vertexID++) {
-        degrees[vertexID] = graph.degree_of(vertexID);
+    for (vertex_t vertexID = from; vertexID < to; vertexID++) {
+        degrees[vertexID].store(graph.degree_of(vertexID), std::memory_order_relaxed);
     }
 
     /* Compute the maximum degree */
     uint32_t max_degree = 0;
-    for (uint32_t vertexID = from; vertexID < to; vertexID++)
-        max_degree = std::max(max_degree, degrees[vertexID]);
+    for (vertex_t vertexID = from; vertexID < to; vertexID++)
+        max_degree = std::max(max_degree, degrees[vertexID].load(std::memory_order_relaxed));
 
     /* The weight and the degree the threads are dealing with. They are initialized to zero at the beginning */
     uint32_t CurrentWeight = 1;
@@ -58,13 +63,15 @@ void SDLSolver::apply_weighting_phase(const Graph &graph, std::vector<uint32_t>
 
     /* Keep working till the globalDegree reached the max degree */
     while (CurrentDegree <= max_degree) {
-        for (uint32_t vertexID = from; vertexID < to; vertexID++) {
-            if (degrees[vertexID] <= CurrentDegree && degrees[vertexID] >= 0) {
+        for (vertex_t vertexID = from; vertexID < to; vertexID++) {
+            if (degrees[vertexID].load(std::memory_order_relaxed) <= CurrentDegree) {
                 weights[vertexID] = CurrentWeight;
-                degrees[vertexID] = -1;
-                for (uint32_t neighbor : graph.neighbors_of(vertexID)) {
-                    if (degrees[neighbor] > 0) {
-                        degrees[neighbor]--;
+                degrees[vertexID].store(-1, std::memory_order_relaxed);
+                for (vertex_t neighbor : graph.neighbors_of(vertexID)) {
+                    // Decrement only if positive: a separate check and fetch_sub could both see 1 when another thread
+                    // decrements the same neighbor, and wrap the degree around
+                    uint32_t degree = degrees[neighbor].load(std::memory_order_relaxed);
+                    while (degree > 0 && !degrees[neighbor].compare_exchange_weak(degree, degree - 1, std::memory_order_relaxed)) {
                     }
                 }
             }
@@ -75,22 +82,25 @@ void SDLSolver::apply_weighting_phase(const Graph &graph, std::vector<uint32_t>
     }
 }
 
-void SDLSolver::apply_coloring_phase(const std::vector<uint32_t> &weights, uint32_t from, uint32_t to, Graph &graph) {
+void SDLSolver::apply_coloring_phase(const std::vector<uint32_t> &weights, vertex_t from, vertex_t to, const Graph &graph, Coloring &coloring, std::vector<vertex_t> &wrong_ones) {
 
     /* Create a vector to represent the vertices to be colored in order and initialize it in ascending order */
-    std::vector<uint32_t> vertices_to_color(to - from);
+    std::vector<vertex_t> vertices_to_color(to - from);
     std::iota(vertices_to_color.begin(), vertices_to_color.end(), from);
 
     /* Sort the vector by weight */
-    std::stable_sort(vertices_to_color.begin(), vertices_to_color.end(), [&](int i, int j) {
+    std::stable_sort(vertices_to_color.begin(), vertices_to_color.end(), [&](vertex_t i, vertex_t j) {
         return weights[i] > weights[j];
     });
 
     /* start coloring according to the order assigned above where no two neighbors have the same color */
     for (const auto &vertex_to_color : vertices_to_color) {
-        uint32_t my_color = graph.color_with_smallest(vertex_to_color);
+        uint32_t my_color = coloring.color_with_smallest(graph, vertex_to_color);
+        // Order the store of my_color before the reads below: if a neighbor is being colored at the same time, at
+        // least one of the two threads then sees the other's color and records the conflict
+        std::atomic_thread_fence(std::memory_order_seq_cst);
         for (const auto &neighbor : graph.neighbors_of(vertex_to_color)) {
-            if (my_color == graph.color_of(neighbor)) {
+            if (my_color == coloring.color_of(neighbor)) {
                 wrong_ones.emplace_back(vertex_to_color);
                 break;
             }
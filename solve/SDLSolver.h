@@ -9,6 +9,8 @@
 
 #include <algorithm>
 
+#include <atomic>
+
 #include <random>
 
 #include <numeric>
@@ -19,18 +21,16 @@ class SDLSolver : public Solver {
 
     uint32_t num_threads;
 
-    std::vector<uint32_t> wrong_ones;
-
-    void apply_weighting_phase(const Graph &graph, std::vector<uint32_t> &degrees, std::vector<uint32_t> &weights, uint32_t from, uint32_t to);
+    void apply_weighting_phase(const Graph &graph, std::vector<std::atomic<uint32_t>> &degrees, std::vector<uint32_t> &weights, vertex_t from, vertex_t to);
 
-    void apply_coloring_phase(const std::vector<uint32_t> &degrees, uint32_t vertex, uint32_t range, Graph &graph);
+    void apply_coloring_phase(const std::vector<uint32_t> &weights, vertex_t from, vertex_t to, const Graph &graph, Coloring &coloring, std::vector<vertex_t> &wrong_ones);
 
   public:
     SDLSolver(int num_threads);
 
     std::string name() const;
 
-    void solve(Graph &);
+    void solve(const Graph &, Coloring &);
 };
 
 #endif //GRAPH_COLORING_SDLSOLVER_H
@@ -1,18 +1,28 @@
 #include "SequentialSolver.h"
+#include <algorithm>
 #include <numeric>
 
 SequentialSolver::SequentialSolver() : random_gen(RANDOM_SEED) {}
 
-void SequentialSolver::solve(Graph &graph) {
+void SequentialSolver::solve(const Graph &graph, Coloring &coloring) {
+    solve_impl(graph, coloring);
+}
+
+void SequentialSolver::solve(const CompressedGraph &graph, Coloring &coloring) {
+    solve_impl(graph, coloring);
+}
+
+template <typename G>
+void SequentialSolver::solve_impl(const G &graph, Coloring &coloring) {
     // Create a random permutation of {v_0, v_1... v_n}
-    std::vector<uint32_t> permutation(graph.num_vertices());
+    std::vector<vertex_t> permutation(graph.num_vertices());
     std::iota(permutation.begin(), permutation.end(), 0);
     std::shuffle(permutation.begin(), permutation.end(), random_gen);
 
     // For each vertex...
-    for (uint32_t index : permutation)
+    for (vertex_t index : permutation)
         // Color it with the smallest color not in its neighbors' colors
-        graph.color_with_smallest(index);
+        coloring.color_with_smallest(graph, index);
 }
 
 std::string SequentialSolver::name() const {
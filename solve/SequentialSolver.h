@@ -7,12 +7,17 @@
 class SequentialSolver : public Solver {
     std::mt19937 random_gen;
 
+    template <typename G>
+    void solve_impl(const G &, Coloring &);
+
   public:
     SequentialSolver();
 
     std::string name() const;
 
-    void solve(Graph &);
+    void solve(const Graph &, Coloring &);
+    bool supports_compressed() const { return true; }
+    void solve(const CompressedGraph &, Coloring &);
 };
 
 #endif //GRAPH_COLORING_SEQUENTIALSOLVER_H
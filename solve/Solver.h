@@ -1,8 +1,12 @@
 #ifndef GRAPH_COLORING_SOLVER_H
 #define GRAPH_COLORING_SOLVER_H
 
+#include "../graph/Coloring.h"
+#include "../graph/CompressedGraph.h"
 #include "../graph/Graph.h"
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #if WITH_RANDOM_SEED
 #define RANDOM_SEED (std::random_device()())
@@ -19,7 +23,20 @@ class Solver {
 
     virtual std::string name() const = 0;
 
-    virtual void solve(Graph &) = 0;
+    // Color the graph, writing the result into the given coloring
+    virtual void solve(const Graph &, Coloring &) = 0;
+
+    // Statistics of the last run, printed by the benchmark next to the time (eg. the number of recolored vertices)
+    virtual std::string details() const { return ""; }
+    // Number of vertices left at the start of each round of the last run, for solvers that work in rounds; the CSV
+    // output has a column for them
+    virtual std::vector<uint64_t> round_sizes() const { return {}; }
+
+    // Solvers that can work on the varint-encoded adjacency lists of a CompressedGraph override both methods below
+    virtual bool supports_compressed() const { return false; }
+    virtual void solve(const CompressedGraph &, Coloring &) {
+        throw std::runtime_error(name() + " does not support compressed graphs");
+    }
 };
 
 #endif //GRAPH_COLORING_SOLVER_H
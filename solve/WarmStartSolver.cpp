@@ -0,0 +1,77 @@
+#include "WarmStartSolver.h"
+#include "../utils/RangeSplitter.h"
+#include <vector>
+
+WarmStartSolver::WarmStartSolver(const Coloring &initial, int num_threads) : initial(initial), num_threads(num_threads) {}
+
+std::string WarmStartSolver::name() const {
+    return "WarmStartSolver (" + std::to_string(num_threads) + " threads)";
+}
+
+std::string WarmStartSolver::details() const {
+    return std::to_string(num_recolored) + " vertices recolored";
+}
+
+void WarmStartSolver::solve(const Graph &graph, Coloring &coloring) {
+    solve_impl(graph, coloring);
+}
+
+void WarmStartSolver::solve(const CompressedGraph &graph, Coloring &coloring) {
+    solve_impl(graph, coloring);
+}
+
+// Whether a neighbor of the vertex with a lower ID has the same color
+template <typename G>
+static bool has_conflict(const G &graph, const Coloring &coloring, vertex_t vertex) {
+    color_t color = coloring.color_of(vertex);
+    for (vertex_t neighbor : graph.neighbors_of(vertex))
+        if (neighbor < vertex && coloring.color_of(neighbor) == color)
+            return true;
+    return false;
+}
+
+// Concatenate the per-thread lists of vertices to recolor
+static std::vector<vertex_t> concatenate(std::vector<std::vector<vertex_t>> &partials) {
+    std::vector<vertex_t> all;
+    for (auto &partial : partials) {
+        all.insert(all.end(), partial.begin(), partial.end());
+        partial.clear();
+    }
+    return all;
+}
+
+template <typename G>
+void WarmStartSolver::solve_impl(const G &graph, Coloring &coloring) {
+    if (initial.num_vertices() != graph.num_vertices())
+        throw std::runtime_error("The initial coloring does not match the graph");
+    parallel_for(graph.num_vertices(), num_threads, [&](int, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; vertex++)
+            coloring.set_color(vertex, initial.color_of(vertex));
+    });
+
+    // Vertices without a color, or with a color above their degree (which first-fit would never give them), are
+    // recolored along with those that conflict with a neighbor
+    std::vector<std::vector<vertex_t>> partials(num_threads);
+    parallel_for(graph.num_vertices(), num_threads, [&](int thread_idx, uint64_t from, uint64_t to) {
+        for (vertex_t vertex = from; vertex < to; vertex++)
+            if (coloring.color_of(vertex) > graph.degree_of(vertex) || has_conflict(graph, coloring, vertex))
+                partials[thread_idx].push_back(vertex);
+    });
+    std::vector<vertex_t> worklist = concatenate(partials);
+
+    num_recolored = 0;
+    while (!worklist.empty()) {
+        num_recolored += worklist.size();
+        parallel_for(worklist.size(), num_threads, [&](int, uint64_t from, uint64_t to) {
+            for (uint64_t i = from; i < to; i++)
+                coloring.color_with_smallest(graph, worklist[i]);
+        });
+        // The colors that were kept are never read stale, so conflicts can only be between vertices of this round
+        parallel_for(worklist.size(), num_threads, [&](int thread_idx, uint64_t from, uint64_t to) {
+            for (uint64_t i = from; i < to; i++)
+                if (has_conflict(graph, coloring, worklist[i]))
+                    partials[thread_idx].push_back(worklist[i]);
+        });
+        worklist = concatenate(partials);
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef GRAPH_COLORING_WARMSTARTSOLVER_H
+#define GRAPH_COLORING_WARMSTARTSOLVER_H
+
+#include "Solver.h"
+
+/* WarmStartSolver repairs a previous coloring (eg. of yesterday's version of the graph, see ColoringFile) instead of
+ * coloring from scratch.
+ *
+ * The initial colors are copied, and a vertex is recolored if it has no color (eg. it is new) or if a neighbor with a
+ * lower ID has the same color, so that the vertices that keep their color form a valid coloring. These are then
+ * recolored with first-fit in parallel rounds: vertices colored in the same round may pick the same color, so after
+ * each round the one with the higher ID of each conflicting pair is recolored in the next. When the graph changed
+ * little, only a few vertices are recolored and most colors stay the same.
+ */
+class WarmStartSolver : public Solver {
+    const Coloring &initial;
+    int num_threads;
+
+    template <typename G>
+    void solve_impl(const G &, Coloring &);
+
+  public:
+    // Vertices recolored by the last run, including those recolored again after a conflict
+    uint64_t num_recolored = 0;
+
+    // The initial coloring must have as many vertices as the graph, and outlive the solver
+    WarmStartSolver(const Coloring &initial, int num_threads = 1);
+
+    std::string name() const;
+    std::string details() const;
+
+    void solve(const Graph &, Coloring &);
+    bool supports_compressed() const { return true; }
+    void solve(const CompressedGraph &, Coloring &);
+};
+
+#endif //GRAPH_COLORING_WARMSTARTSOLVER_H
@@ -0,0 +1,282 @@
+#include "BlockReader.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Direct I/O requires buffers, offsets and sizes aligned to the logical block size of the device, which is at most
+// the page size in practice
+static const size_t ALIGNMENT = 4096;
+
+/* Ring is a minimal io_uring client: one submission and one completion queue shared with the kernel, used by a single
+ * thread. The kernel writes the completion tail and reads the submission tail, so those are accessed with
+ * acquire/release semantics.
+ */
+class BlockReader::Ring {
+    int ring_fd = -1;
+    void *sq_mapping = MAP_FAILED, *cq_mapping = MAP_FAILED;
+    size_t sq_mapping_size = 0, cq_mapping_size = 0;
+    io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+    size_t sqes_size = 0;
+    unsigned *sq_tail = nullptr, *sq_mask = nullptr, *sq_array = nullptr;
+    unsigned *cq_head = nullptr, *cq_tail = nullptr, *cq_mask = nullptr;
+    io_uring_cqe *cqes = nullptr;
+
+    void release() {
+        if (sqes != MAP_FAILED)
+            munmap(sqes, sqes_size);
+        if (cq_mapping != MAP_FAILED && cq_mapping != sq_mapping)
+            munmap(cq_mapping, cq_mapping_size);
+        if (sq_mapping != MAP_FAILED)
+            munmap(sq_mapping, sq_mapping_size);
+        if (ring_fd >= 0)
+            close(ring_fd);
+    }
+
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        return int(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+    }
+
+  public:
+    // Throws if io_uring is unavailable
+    Ring(unsigned entries) {
+        io_uring_params params = {};
+        ring_fd = int(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd < 0)
+            throw std::runtime_error("io_uring is not available");
+        try {
+            map_rings(params);
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ~Ring() { release(); }
+
+    void map_rings(const io_uring_params &params) {
+        sq_mapping_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_mapping_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        // Recent kernels map both rings at once
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            sq_mapping_size = cq_mapping_size = std::max(sq_mapping_size, cq_mapping_size);
+        sq_mapping = mmap(nullptr, sq_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+        if (sq_mapping == MAP_FAILED)
+            throw std::runtime_error("Failed to map the io_uring submission queue");
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            cq_mapping = sq_mapping;
+        else
+            cq_mapping = mmap(nullptr, cq_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        if (cq_mapping == MAP_FAILED)
+            throw std::runtime_error("Failed to map the io_uring completion queue");
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe *>(mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED)
+            throw std::runtime_error("Failed to map the io_uring submission entries");
+
+        auto sq = static_cast<char *>(sq_mapping), cq = static_cast<char *>(cq_mapping);
+        sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    }
+
+    // Submit a read of size bytes at offset into buffer, tagged with user_data
+    void submit_read(int fd, char *buffer, size_t size, uint64_t offset, uint64_t user_data) {
+        unsigned tail = *sq_tail;
+        unsigned index = tail & *sq_mask;
+        io_uring_sqe &sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer);
+        sqe.len = unsigned(size);
+        sqe.off = offset;
+        sqe.user_data = user_data;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        while (enter(1, 0, 0) < 0)
+            if (errno != EINTR)
+                throw std::runtime_error(std::string("io_uring submission failed: ") + std::strerror(errno));
+    }
+
+    // Wait for a completion, and return its user_data and result
+    std::pair<uint64_t, int64_t> wait_completion() {
+        while (true) {
+            unsigned head = *cq_head;
+            if (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                const io_uring_cqe &cqe = cqes[head & *cq_mask];
+                std::pair<uint64_t, int64_t> completion(cqe.user_data, cqe.res);
+                __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+                return completion;
+            }
+            if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                throw std::runtime_error(std::string("io_uring wait failed: ") + std::strerror(errno));
+        }
+    }
+};
+
+BlockReader::BlockReader(const std::string &path, size_t block_size, unsigned queue_depth)
+    : path(path), direct(true), block_size((std::max<size_t>(block_size, 1) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT) {
+    fd = open(path.c_str(), O_RDONLY | O_DIRECT);
+    if (fd == -1 && errno == EINVAL) {
+        direct = false;
+        fd = open(path.c_str(), O_RDONLY);
+    }
+    if (fd == -1)
+        throw std::runtime_error("Failed to open file.");
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        close(fd);
+        throw std::runtime_error("Failed to stat " + path);
+    }
+    file_size = info.st_size;
+    if (!direct)
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    try {
+        ring = std::make_unique<Ring>(std::max(queue_depth, 1u));
+    } catch (const std::runtime_error &) {
+        // Read one block at a time with pread
+        queue_depth = 1;
+    }
+    slots.resize(std::max(queue_depth, 1u));
+    try {
+        for (slot_t &slot : slots) {
+            slot.buffer = static_cast<char *>(std::aligned_alloc(ALIGNMENT, this->block_size));
+            if (slot.buffer == nullptr)
+                throw std::bad_alloc();
+        }
+        for (slot_t &slot : slots)
+            request(slot);
+    } catch (...) {
+        // The destructor does not run if the constructor throws
+        release();
+        throw;
+    }
+}
+
+BlockReader::~BlockReader() {
+    release();
+}
+
+void BlockReader::release() {
+    // The kernel may still write into the buffers of reads in flight
+    if (ring) {
+        try {
+            for (slot_t &slot : slots)
+                if (slot.pending)
+                    wait(slot);
+        } catch (const std::runtime_error &) {
+            // Closing the ring cancels the remaining reads
+            ring.reset();
+        }
+    }
+    for (slot_t &slot : slots)
+        std::free(slot.buffer);
+    slots.clear();
+    close(fd);
+}
+
+void BlockReader::request(slot_t &slot) {
+    slot.complete = false;
+    if (next_offset >= file_size)
+        return;
+    slot.offset = next_offset;
+    slot.filled = 0;
+    next_offset += block_size;
+    slot.pending = true;
+    // Whole blocks are requested even at the end of the file, as direct I/O requires, and the read returns less
+    if (ring) {
+        if (in_flight++ == 0)
+            busy_since = std::chrono::steady_clock::now();
+        ring->submit_read(fd, slot.buffer, block_size, slot.offset, &slot - slots.data());
+    }
+}
+
+void BlockReader::complete(slot_t &slot, int64_t result) {
+    if (result > 0) {
+        slot.filled += result;
+        // A read may return less than requested before the end of the file: request the rest of the block, at the
+        // same (aligned) position it stopped at
+        uint64_t expected = std::min<uint64_t>(block_size, file_size - slot.offset);
+        if (slot.filled < expected) {
+            ring->submit_read(fd, slot.buffer + slot.filled, block_size - slot.filled, slot.offset + slot.filled, &slot - slots.data());
+            return;
+        }
+    }
+    slot.result = result < 0 ? result : int64_t(slot.filled);
+    slot.pending = false;
+    slot.complete = true;
+    if (--in_flight == 0)
+        busy_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - busy_since).count();
+}
+
+void BlockReader::wait(slot_t &slot) {
+    if (!ring) {
+        // pread may return less than requested before the end of the file, so read until it returns 0
+        auto start = std::chrono::steady_clock::now();
+        slot.result = 0;
+        while (uint64_t(slot.result) < block_size) {
+            ssize_t result = pread(fd, slot.buffer + slot.result, block_size - slot.result, slot.offset + slot.result);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result < 0) {
+                slot.result = -errno;
+                break;
+            }
+            if (result == 0)
+                break;
+            slot.result += result;
+        }
+        slot.pending = false;
+        slot.complete = true;
+        busy_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return;
+    }
+    // Completions may arrive out of order, so the other slots are marked as they complete
+    while (slot.pending) {
+        auto completion = ring->wait_completion();
+        complete(slots[completion.first], completion.second);
+    }
+}
+
+size_t BlockReader::read(char *buffer, size_t capacity) {
+    size_t copied = 0;
+    while (copied < capacity) {
+        slot_t &slot = slots[current];
+        if (!slot.pending && !slot.complete)
+            break;
+        if (!slot.complete)
+            wait(slot);
+        if (slot.result < 0)
+            throw std::runtime_error("Failed to read " + path + ": " + std::strerror(int(-slot.result)));
+        // Short reads were resubmitted, so a block can only be short if the file shrank
+        uint64_t expected = std::min<uint64_t>(block_size, file_size - slot.offset);
+        if (uint64_t(slot.result) < expected)
+            throw std::runtime_error("Unexpected end of " + path);
+
+        size_t size = std::min<size_t>(capacity - copied, expected - position);
+        std::memcpy(buffer + copied, slot.buffer + position, size);
+        copied += size;
+        position += size;
+        if (position == expected) {
+            // Reuse the slot for the next block to request, and move on to the next one in file order
+            request(slot);
+            current = (current + 1) % slots.size();
+            position = 0;
+        }
+    }
+    return copied;
+}
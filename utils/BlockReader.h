@@ -0,0 +1,73 @@
+#ifndef GRAPH_COLORING_BLOCKREADER_H
+#define GRAPH_COLORING_BLOCKREADER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* BlockReader reads a file sequentially with large aligned reads that bypass the page cache (O_DIRECT), keeping
+ * several of them in flight with io_uring so that the device is never idle while the caller consumes a block.
+ *
+ * io_uring is used through its system calls, so no library is needed; if the kernel does not provide it (or forbids
+ * it), blocks are read with pread, one at a time. Filesystems without O_DIRECT support (eg. tmpfs) are read through the
+ * page cache. Since each read of the caller is served from a completed block, the interface is the same as that of
+ * Decompressor, and TextStream reads from either.
+ */
+class BlockReader {
+    class Ring;
+
+    struct slot_t {
+        // Aligned buffer of block_size bytes
+        char *buffer = nullptr;
+        uint64_t offset = 0;
+        // Bytes read, or -errno; only valid once the read is complete
+        int64_t result = 0;
+        // Bytes read so far, when a short read is resubmitted for the rest of the block
+        uint64_t filled = 0;
+        bool pending = false, complete = false;
+    };
+
+    std::string path;
+    int fd;
+    bool direct;
+    uint64_t file_size;
+    size_t block_size;
+    std::unique_ptr<Ring> ring;
+    std::vector<slot_t> slots;
+    // Offset of the next block to request, slot of the block being consumed and position in it
+    uint64_t next_offset = 0;
+    size_t current = 0, position = 0;
+    // Time during which at least one read was in flight, and the number in flight
+    std::chrono::steady_clock::time_point busy_since;
+    double busy_seconds = 0;
+    unsigned in_flight = 0;
+
+    // Start reading the next block into a slot, if any is left
+    void request(slot_t &slot);
+    // Record a completed read of the slot, resubmitting the rest of the block if the read was short
+    void complete(slot_t &slot, int64_t result);
+    // Wait until the slot holds its block
+    void wait(slot_t &slot);
+    // Wait for the reads in flight, and free the buffers and the descriptor
+    void release();
+
+  public:
+    // block_size is rounded up to a multiple of the alignment of direct I/O; queue_depth blocks are in flight at once
+    BlockReader(const std::string &path, size_t block_size = 4 << 20, unsigned queue_depth = 4);
+    ~BlockReader();
+
+    BlockReader(const BlockReader &) = delete;
+    BlockReader &operator=(const BlockReader &) = delete;
+
+    // Copy up to `capacity` bytes of the file into buffer, and return their number; 0 means the end of the file
+    size_t read(char *buffer, size_t capacity);
+
+    // Seconds during which reads were in flight so far. Completions are only noticed when the caller asks for the
+    // next block, so this is an upper bound, and file_size / busy() a lower bound of the rate the device delivered.
+    double busy() const { return busy_seconds; }
+};
+
+#endif //GRAPH_COLORING_BLOCKREADER_H
@@ -0,0 +1,178 @@
+#include "Decompressor.h"
+#include <algorithm>
+#include <climits>
+#include <filesystem>
+#include <stdexcept>
+#if defined(GRAPH_WITH_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(GRAPH_WITH_LZMA)
+#include <lzma.h>
+#endif
+#if defined(GRAPH_WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+struct Decompressor::backend_t {
+    virtual ~backend_t() = default;
+    virtual size_t read(char *buffer, size_t capacity) = 0;
+};
+
+namespace {
+
+#if defined(GRAPH_WITH_ZLIB)
+class GzipBackend : public Decompressor::backend_t {
+    z_stream stream = {};
+    // zlib counts bytes with 32-bit integers, so the input is fed in chunks
+    const uint8_t *pos, *end;
+    bool finished = false;
+
+  public:
+    GzipBackend(const uint8_t *data, size_t size) : pos(data), end(data + size) {
+        // 15 + 32: the largest window, and automatic detection of gzip and zlib headers
+        if (inflateInit2(&stream, 15 + 32) != Z_OK)
+            throw std::runtime_error("Failed to initialize zlib");
+    }
+    ~GzipBackend() override { inflateEnd(&stream); }
+
+    size_t read(char *buffer, size_t capacity) override {
+        stream.next_out = reinterpret_cast<Bytef *>(buffer);
+        stream.avail_out = std::min<size_t>(capacity, UINT_MAX);
+        uInt initial = stream.avail_out;
+        while (stream.avail_out != 0 && !finished) {
+            if (stream.avail_in == 0) {
+                size_t chunk = std::min<size_t>(end - pos, 1u << 30);
+                stream.next_in = const_cast<Bytef *>(pos);
+                stream.avail_in = chunk;
+                pos += chunk;
+            }
+            int result = inflate(&stream, Z_NO_FLUSH);
+            if (result == Z_STREAM_END) {
+                // Another member may follow
+                if (stream.avail_in == 0 && pos == end)
+                    finished = true;
+                else
+                    inflateReset(&stream);
+            } else if (result == Z_BUF_ERROR && stream.avail_in == 0 && pos == end) {
+                throw std::runtime_error("Truncated gzip file");
+            } else if (result != Z_OK) {
+                throw std::runtime_error("Corrupt gzip file");
+            }
+        }
+        return initial - stream.avail_out;
+    }
+};
+#endif
+
+#if defined(GRAPH_WITH_LZMA)
+class XzBackend : public Decompressor::backend_t {
+    lzma_stream stream = LZMA_STREAM_INIT;
+    bool finished = false;
+
+  public:
+    XzBackend(const uint8_t *data, size_t size) {
+        if (lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+            throw std::runtime_error("Failed to initialize liblzma");
+        stream.next_in = data;
+        stream.avail_in = size;
+    }
+    ~XzBackend() override { lzma_end(&stream); }
+
+    size_t read(char *buffer, size_t capacity) override {
+        stream.next_out = reinterpret_cast<uint8_t *>(buffer);
+        stream.avail_out = capacity;
+        while (stream.avail_out != 0 && !finished) {
+            // All the input is available, so the decoder may finish
+            lzma_ret result = lzma_code(&stream, LZMA_FINISH);
+            if (result == LZMA_STREAM_END)
+                finished = true;
+            else if (result == LZMA_BUF_ERROR)
+                throw std::runtime_error("Truncated xz file");
+            else if (result != LZMA_OK)
+                throw std::runtime_error("Corrupt xz file");
+        }
+        return capacity - stream.avail_out;
+    }
+};
+#endif
+
+#if defined(GRAPH_WITH_ZSTD)
+class ZstdBackend : public Decompressor::backend_t {
+    ZSTD_DCtx *context;
+    ZSTD_inBuffer input;
+    // Hint returned by the last call: 0 once a frame is complete
+    size_t pending;
+
+  public:
+    ZstdBackend(const uint8_t *data, size_t size) : context(ZSTD_createDCtx()), input{data, size, 0}, pending(size != 0) {
+        if (context == nullptr)
+            throw std::runtime_error("Failed to initialize zstd");
+    }
+    ~ZstdBackend() override { ZSTD_freeDCtx(context); }
+
+    size_t read(char *buffer, size_t capacity) override {
+        ZSTD_outBuffer output = {buffer, capacity, 0};
+        while (output.pos < output.size) {
+            // Frames follow each other until the end of the input
+            if (input.pos == input.size && pending == 0)
+                break;
+            size_t before = output.pos;
+            pending = ZSTD_decompressStream(context, &output, &input);
+            if (ZSTD_isError(pending))
+                throw std::runtime_error(std::string("Corrupt zstd file: ") + ZSTD_getErrorName(pending));
+            if (input.pos == input.size && output.pos == before && pending != 0)
+                throw std::runtime_error("Truncated zstd file");
+        }
+        return output.pos;
+    }
+};
+#endif
+
+} // namespace
+
+Decompressor::format_t Decompressor::format_of(const std::string &path) {
+    auto extension = std::filesystem::path(path).extension();
+    if (extension == ".gz")
+        return GZIP;
+    if (extension == ".xz")
+        return XZ;
+    if (extension == ".zst")
+        return ZSTD;
+    return NONE;
+}
+
+std::string Decompressor::strip_extension(const std::string &path) {
+    if (format_of(path) == NONE)
+        return path;
+    return std::filesystem::path(path).replace_extension().string();
+}
+
+Decompressor::Decompressor(const std::string &path) : file(path) {
+    switch (format_of(path)) {
+#if defined(GRAPH_WITH_ZLIB)
+    case GZIP:
+        backend = std::make_unique<GzipBackend>(file.data(), file.size());
+        break;
+#endif
+#if defined(GRAPH_WITH_LZMA)
+    case XZ:
+        backend = std::make_unique<XzBackend>(file.data(), file.size());
+        break;
+#endif
+#if defined(GRAPH_WITH_ZSTD)
+    case ZSTD:
+        backend = std::make_unique<ZstdBackend>(file.data(), file.size());
+        break;
+#endif
+    case NONE:
+        throw std::runtime_error("Not a compressed file: " + path);
+    default:
+        throw std::runtime_error("Support for " + std::filesystem::path(path).extension().string() + " files was not compiled in");
+    }
+}
+
+Decompressor::~Decompressor() = default;
+
+size_t Decompressor::read(char *buffer, size_t capacity) {
+    return backend->read(buffer, capacity);
+}
@@ -0,0 +1,43 @@
+#ifndef GRAPH_COLORING_DECOMPRESSOR_H
+#define GRAPH_COLORING_DECOMPRESSOR_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/* Decompressor reads a gzip, xz or zstd file (recognized by its .gz, .xz or .zst extension) as a stream of
+ * decompressed bytes. The compressed file is mapped and fed to the library as a whole, so the only copy of the data is
+ * the output buffer of each read. Concatenated streams (eg. from pigz or pixz) are read in sequence.
+ *
+ * Each format is only available if its library was found at build time (see CMakeLists.txt); opening a file in a
+ * missing format throws.
+ */
+class Decompressor {
+  public:
+    enum format_t { NONE,
+                    GZIP,
+                    XZ,
+                    ZSTD };
+
+    // Implemented for each format in Decompressor.cpp
+    struct backend_t;
+
+  private:
+    MappedFile file;
+    std::unique_ptr<backend_t> backend;
+
+  public:
+    // The compression format of a file, by extension
+    static format_t format_of(const std::string &path);
+    // The path without its compression extension, eg. "road.gra" for "road.gra.gz"
+    static std::string strip_extension(const std::string &path);
+
+    Decompressor(const std::string &path);
+    ~Decompressor();
+
+    // Decompress up to `capacity` bytes into buffer, and return their number; 0 means the end of the file
+    size_t read(char *buffer, size_t capacity);
+};
+
+#endif //GRAPH_COLORING_DECOMPRESSOR_H
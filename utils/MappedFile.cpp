@@ -0,0 +1,34 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &path) : bytes(nullptr), length(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        throw std::runtime_error("Failed to open file.");
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        close(fd);
+        throw std::runtime_error("Failed to stat " + path);
+    }
+    length = info.st_size;
+    // mmap does not accept empty mappings; an empty file is reported as truncated by the parser
+    if (length != 0) {
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Failed to map " + path);
+        }
+        bytes = static_cast<const uint8_t *>(mapping);
+    }
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (bytes != nullptr)
+        munmap(const_cast<uint8_t *>(bytes), length);
+}
@@ -0,0 +1,26 @@
+#ifndef GRAPH_COLORING_MAPPEDFILE_H
+#define GRAPH_COLORING_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* MappedFile maps a whole file read-only into memory. The mapping is shared, so several processes working on the same
+ * file use the same pages of the page cache, and pages are only read from disk when first accessed.
+ */
+class MappedFile {
+    const uint8_t *bytes;
+    size_t length;
+
+  public:
+    MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const uint8_t *data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+#endif //GRAPH_COLORING_MAPPEDFILE_H
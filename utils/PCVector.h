@@ -11,6 +11,7 @@
 #endif
 
 // A vector that implements the producer-consumer pattern.
+// If a capacity is given, push() blocks while the vector holds that many items.
 template <typename T>
 class PCVector {
   public:
@@ -19,9 +20,13 @@ class PCVector {
   private:
     std::vector<T> data;
     bool stopped;
+    // Maximum number of items, or 0 for no limit
+    size_t capacity = 0;
 
     std::mutex mutex;
     sem_t full_or_done;
+    // Free slots, if there is a capacity
+    sem_t not_full;
 
     // Threads used by onReceive
     std::vector<std::thread> threads;
@@ -29,18 +34,27 @@ class PCVector {
   public:
     PCVector() : stopped(false) {
         sem_init(&full_or_done, 0, 0);
+        sem_init(&not_full, 0, 0);
+    }
+    explicit PCVector(size_t _capacity) : stopped(false), capacity(_capacity) {
+        sem_init(&full_or_done, 0, 0);
+        sem_init(&not_full, 0, capacity);
     }
     PCVector(std::vector<T> &&_data) : data(std::move(_data)), stopped(false) {
         sem_init(&full_or_done, 0, data.size());
+        sem_init(&not_full, 0, 0);
     }
     ~PCVector() {
         sem_destroy(&full_or_done);
+        sem_destroy(&not_full);
     }
 
-    // Produce item val
+    // Produce item val; if the queue is full, wait until an item is consumed
     void push(const T &val) {
         if (stopped)
             throw std::runtime_error("Writing to stopped queue");
+        if (capacity != 0)
+            sem_wait(&not_full);
         mutex.lock();
         data.emplace_back(val);
         mutex.unlock();
@@ -60,6 +74,8 @@ class PCVector {
             return std::nullopt;
         T ret = data.back();
         data.pop_back();
+        if (capacity != 0)
+            sem_post(&not_full);
         return ret;
     };
 
@@ -0,0 +1,208 @@
+#include "PageAllocator.h"
+#include "RangeSplitter.h"
+#include <fstream>
+#include <linux/mempolicy.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Smaller allocations are not worth a mapping of their own
+static const size_t MIN_MAPPED_SIZE = 2 * 1024 * 1024;
+
+static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+static size_t small_page_size() {
+    static const size_t size = sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+// Size of the pages handed out by hugetlbfs (Hugepagesize in /proc/meminfo), or 0 if unknown
+static size_t explicit_huge_page_size() {
+    static const size_t size = []() -> size_t {
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        size_t kilobytes;
+        while (meminfo >> key) {
+            if (key == "Hugepagesize:" && meminfo >> kilobytes)
+                return kilobytes * 1024;
+            meminfo.ignore(256, '\n');
+        }
+        return 0;
+    }();
+    return size;
+}
+
+// Size of transparent huge pages, or 0 if they are disabled
+static size_t transparent_huge_page_size() {
+    static const size_t size = []() -> size_t {
+        std::ifstream enabled("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string mode;
+        std::getline(enabled, mode);
+        if (mode.empty() || mode.find("[never]") != std::string::npos)
+            return 0;
+        std::ifstream pmd_size("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+        size_t bytes = 0;
+        pmd_size >> bytes;
+        return bytes;
+    }();
+    return size;
+}
+
+// Bitmask of the online NUMA nodes, parsed from a list such as "0-1,3"
+static unsigned long online_numa_nodes() {
+    std::ifstream online("/sys/devices/system/node/online");
+    unsigned long mask = 0;
+    unsigned first, last;
+    char separator;
+    while (online >> first) {
+        last = first;
+        if (online.peek() == '-')
+            online >> separator >> last;
+        for (unsigned node = first; node <= last && node < 8 * sizeof(mask); node++)
+            mask |= 1ul << node;
+        if (online.peek() == ',')
+            online >> separator;
+    }
+    return mask;
+}
+
+AllocationPolicy &AllocationPolicy::global() {
+    static AllocationPolicy policy;
+    return policy;
+}
+
+AllocationPolicy::pages_t AllocationPolicy::parse_pages(const std::string &name) {
+    if (name == "default")
+        return DEFAULT_PAGES;
+    if (name == "thp")
+        return TRANSPARENT_HUGE_PAGES;
+    if (name == "hugetlb")
+        return EXPLICIT_HUGE_PAGES;
+    throw std::runtime_error("Unknown page policy: " + name);
+}
+
+AllocationPolicy::numa_t AllocationPolicy::parse_numa(const std::string &name) {
+    if (name == "default")
+        return NUMA_DEFAULT;
+    if (name == "first-touch")
+        return FIRST_TOUCH;
+    if (name == "interleave")
+        return INTERLEAVE;
+    throw std::runtime_error("Unknown NUMA policy: " + name);
+}
+
+void AllocationPolicy::configure(pages_t pages_policy, numa_t numa_policy, int threads) {
+    pages = pages_policy;
+    numa = numa_policy;
+    num_threads = threads;
+}
+
+void *AllocationPolicy::allocate(size_t bytes) {
+    if ((pages == DEFAULT_PAGES && numa == NUMA_DEFAULT) || bytes < MIN_MAPPED_SIZE)
+        return ::operator new(bytes);
+    return map_region(bytes);
+}
+
+void AllocationPolicy::deallocate(void *p, size_t bytes) {
+    // Only large allocations may be mapped, and none are until a policy other than the default is used, so the common
+    // case does not need the lock
+    if (bytes < MIN_MAPPED_SIZE || !mapped_any.load(std::memory_order_acquire)) {
+        ::operator delete(p);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(regions_mutex);
+        auto region = regions.find(p);
+        if (region != regions.end()) {
+            munmap(region->first, region->second);
+            regions.erase(region);
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
+void *AllocationPolicy::map_region(size_t bytes) {
+    void *region = MAP_FAILED;
+    size_t length = 0;
+    bool is_explicit = false, is_transparent = false;
+
+    if (pages == EXPLICIT_HUGE_PAGES && explicit_huge_page_size() != 0) {
+        // Fails right away if not enough huge pages are reserved (vm.nr_hugepages), in which case we fall back below
+        length = round_up(bytes, explicit_huge_page_size());
+        region = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        is_explicit = region != MAP_FAILED;
+    }
+
+    if (region == MAP_FAILED) {
+        size_t alignment = pages != DEFAULT_PAGES ? transparent_huge_page_size() : 0;
+        length = round_up(bytes, small_page_size());
+        if (alignment == 0) {
+            region = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (region == MAP_FAILED)
+                throw std::bad_alloc();
+        } else {
+            // Align the region to the huge page size, so that it is fully covered by huge pages
+            size_t padded = length + alignment;
+            char *padded_region = static_cast<char *>(mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (padded_region == MAP_FAILED)
+                throw std::bad_alloc();
+            char *aligned = reinterpret_cast<char *>(round_up(reinterpret_cast<uintptr_t>(padded_region), alignment));
+            if (aligned != padded_region)
+                munmap(padded_region, aligned - padded_region);
+            munmap(aligned + length, padded_region + padded - (aligned + length));
+            region = aligned;
+            is_transparent = madvise(region, length, MADV_HUGEPAGE) == 0;
+        }
+    }
+
+    place(region, length);
+
+    std::lock_guard<std::mutex> lock(regions_mutex);
+    regions[region] = length;
+    mapped_any.store(true, std::memory_order_release);
+    used_explicit |= is_explicit;
+    used_transparent |= is_transparent;
+    used_small_pages |= !is_explicit && !is_transparent;
+    return region;
+}
+
+void AllocationPolicy::place(void *region, size_t length) {
+    if (numa == INTERLEAVE) {
+        // Only worth it (and only allowed by the kernel) with more than one node; placement is best effort
+        unsigned long nodes = online_numa_nodes();
+        if ((nodes & (nodes - 1)) != 0)
+            syscall(SYS_mbind, region, length, MPOL_INTERLEAVE, &nodes, 8 * sizeof(nodes), 0);
+    } else if (numa == FIRST_TOUCH) {
+        // Fault the pages in from several threads, each touching an equal slice of bytes, so that the region is spread
+        // over the nodes those threads ran on rather than all placed on the node of the allocating thread. The threads
+        // are not pinned, and slices are by bytes rather than by vertices, so this does not follow the partitions of
+        // the solvers.
+        char *bytes = static_cast<char *>(region);
+        size_t page = small_page_size();
+        parallel_for(length / page, num_threads, [bytes, page](int, uint64_t from, uint64_t to) {
+            for (uint64_t idx = from; idx < to; idx++)
+                bytes[idx * page] = 0;
+        });
+    }
+}
+
+std::string AllocationPolicy::page_size() {
+    std::lock_guard<std::mutex> lock(regions_mutex);
+    std::string description;
+    auto add = [&description](size_t size, const std::string &kind) {
+        if (!description.empty())
+            description += " + ";
+        description += std::to_string(size / 1024) + " KB" + kind;
+    };
+    if (used_explicit)
+        add(explicit_huge_page_size(), " (hugetlbfs)");
+    if (used_transparent)
+        add(transparent_huge_page_size(), " (transparent)");
+    if (used_small_pages || description.empty())
+        add(small_page_size(), "");
+    return description;
+}
@@ -0,0 +1,94 @@
+#ifndef GRAPH_COLORING_PAGEALLOCATOR_H
+#define GRAPH_COLORING_PAGEALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/* AllocationPolicy decides how the large arrays of the program (CSR arrays, colorings) are backed by memory.
+ *
+ * Solvers read the colors of neighbors at random, so on large graphs most accesses miss the TLB, and on multi-socket
+ * machines half of them hit the memory of the other socket. Large allocations can therefore be:
+ *  - backed by huge pages, either transparent ones (madvise(MADV_HUGEPAGE)) or explicit ones from hugetlbfs
+ *    (MAP_HUGETLB, falling back to transparent huge pages if none are reserved);
+ *  - placed on NUMA nodes by first touch, where num_threads short-lived threads each fault in an equal slice of the
+ *    bytes of the region (so the pages are spread over the nodes the scheduler runs them on, with no relation to the
+ *    vertex partitions of any solver), or interleaved page by page over all nodes.
+ *
+ * Small allocations, and all allocations under the default policy, go through operator new.
+ * The policy is global and must be set before the graph is parsed (see main.cpp).
+ */
+class AllocationPolicy {
+  public:
+    enum pages_t { DEFAULT_PAGES,
+                   TRANSPARENT_HUGE_PAGES,
+                   EXPLICIT_HUGE_PAGES };
+    enum numa_t { NUMA_DEFAULT,
+                  FIRST_TOUCH,
+                  INTERLEAVE };
+
+  private:
+    pages_t pages = DEFAULT_PAGES;
+    numa_t numa = NUMA_DEFAULT;
+    int num_threads = 1;
+
+    // Regions obtained with mmap, with their mapped length, so that they can be told apart on deallocation
+    std::mutex regions_mutex;
+    std::map<void *, size_t> regions;
+    // Whether any region was mapped so far
+    std::atomic<bool> mapped_any = false;
+    // Page kinds actually obtained so far (fallbacks included)
+    bool used_small_pages = false, used_transparent = false, used_explicit = false;
+
+    void *map_region(size_t bytes);
+    void place(void *region, size_t length);
+
+  public:
+    // The policy used by PolicyAllocator
+    static AllocationPolicy &global();
+
+    // Parse "default", "thp" or "hugetlb"
+    static pages_t parse_pages(const std::string &);
+    // Parse "default", "first-touch" or "interleave"
+    static numa_t parse_numa(const std::string &);
+
+    // num_threads is the number of threads (and equal byte slices) used for first-touch placement
+    void configure(pages_t, numa_t, int num_threads);
+
+    void *allocate(size_t bytes);
+    void deallocate(void *, size_t bytes);
+
+    // Describe the page size backing large allocations so far, eg. "4 KB" or "2048 KB (transparent)"
+    std::string page_size();
+};
+
+// A standard allocator that forwards to AllocationPolicy::global()
+template <typename T>
+struct PolicyAllocator {
+    using value_type = T;
+    // All instances share the global policy, so containers can always exchange their buffers on move
+    using is_always_equal = std::true_type;
+
+    PolicyAllocator() = default;
+    template <typename U>
+    PolicyAllocator(const PolicyAllocator<U> &) {}
+
+    T *allocate(size_t n) { return static_cast<T *>(AllocationPolicy::global().allocate(n * sizeof(T))); }
+    void deallocate(T *p, size_t n) { AllocationPolicy::global().deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const PolicyAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const PolicyAllocator<U> &) const { return false; }
+};
+
+template <typename T>
+using policy_vector = std::vector<T, PolicyAllocator<T>>;
+
+#endif //GRAPH_COLORING_PAGEALLOCATOR_H
@@ -2,24 +2,27 @@
 #define GRAPH_COLORING_RANGESPLITTER_H
 
 #include "span-lite.hpp"
-#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <thread>
 #include <vector>
 
 class RangeSplitter {
-    int max;
-    int items_per_range;
+    uint64_t max;
+    uint64_t items_per_range;
 
   public:
-    RangeSplitter(int max, int num_ranges) : max(max) {
-        items_per_range = std::ceil(float(max) / float(num_ranges));
+    // Integer rounding: a float quotient loses precision above 2^24 and would leave the last items uncovered
+    RangeSplitter(uint64_t max, int num_ranges) : max(max) {
+        items_per_range = (max + num_ranges - 1) / num_ranges;
     };
 
     // Get the lower end for the i-th range
-    inline int get_min(int index) const {
+    inline uint64_t get_min(int index) const {
         return std::min(items_per_range * index, max);
     };
     // Get the higher end for the i-th range
-    inline int get_max(int index) const {
+    inline uint64_t get_max(int index) const {
         return std::min(items_per_range * (index + 1), max);
     };
     // Get whether the i-th range is empty
@@ -44,4 +47,22 @@ class VectorSplitter {
     };
 };
 
+// Split [0, max) in num_threads ranges and call fn(thread_idx, from, to) for each one on its own thread.
+// Returns when all threads are done; with a single thread, fn runs on the calling thread.
+template <typename F>
+void parallel_for(uint64_t max, int num_threads, F &&fn) {
+    RangeSplitter rs(max, num_threads);
+    if (num_threads == 1) {
+        fn(0, rs.get_min(0), rs.get_max(0));
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (int thread_idx = 0; thread_idx < num_threads; thread_idx++)
+        threads.emplace_back([&fn, &rs, thread_idx]() {
+            fn(thread_idx, rs.get_min(thread_idx), rs.get_max(thread_idx));
+        });
+    for (auto &thread : threads)
+        thread.join();
+}
+
 #endif //GRAPH_COLORING_RANGESPLITTER_H
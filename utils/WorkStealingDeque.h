@@ -0,0 +1,104 @@
+#ifndef GRAPH_COLORING_WORKSTEALINGDEQUE_H
+#define GRAPH_COLORING_WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/* A Chase-Lev work-stealing deque ("Dynamic Circular Work-Stealing Deque", D. Chase and Y. Lev, 2005), with the
+ * memory orderings of "Correct and Efficient Work-Stealing for Weak Memory Models", N. M. Lê et al., 2013.
+ *
+ * The owner thread pushes and pops items at the bottom, in LIFO order, without locks and (unless a single item is
+ * left) without atomic read-modify-write operations; other threads steal the oldest items from the top with a CAS.
+ * When the circular buffer fills up it is replaced with one twice as large; old buffers are kept until the deque is
+ * destroyed, since a thief may still be reading from them.
+ */
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "Items are copied with atomic loads and stores");
+
+    struct buffer_t {
+        int64_t capacity;
+        std::unique_ptr<std::atomic<T>[]> items;
+
+        buffer_t(int64_t capacity) : capacity(capacity), items(new std::atomic<T>[capacity]) {}
+        T get(int64_t index) const { return items[index & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t index, T item) { items[index & (capacity - 1)].store(item, std::memory_order_relaxed); }
+    };
+
+    // Thieves and the owner on separate cache lines
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<buffer_t *> buffer;
+    // Every buffer allocated so far, including the current one
+    std::vector<std::unique_ptr<buffer_t>> buffers;
+
+    buffer_t *grow(buffer_t *old, int64_t top_index, int64_t bottom_index) {
+        buffers.push_back(std::make_unique<buffer_t>(old->capacity * 2));
+        buffer_t *grown = buffers.back().get();
+        for (int64_t index = top_index; index < bottom_index; index++)
+            grown->put(index, old->get(index));
+        buffer.store(grown, std::memory_order_release);
+        return grown;
+    }
+
+  public:
+    // The capacity must be a power of two
+    WorkStealingDeque(int64_t initial_capacity = 1024) : top(0), bottom(0) {
+        buffers.push_back(std::make_unique<buffer_t>(initial_capacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    // Owner only: add an item at the bottom
+    void push(T item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        buffer_t *current = buffer.load(std::memory_order_relaxed);
+        if (b - t > current->capacity - 1)
+            current = grow(current, t, b);
+        current->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only: take the item at the bottom (the newest one). Return false if the deque is empty.
+    bool pop(T &item) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        buffer_t *current = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = current->get(b);
+        if (t == b) {
+            // The last item: race against the thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread: take the item at the top (the oldest one). Return false if the deque is empty or another thread
+    // took the item first.
+    bool steal(T &item) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return false;
+        buffer_t *current = buffer.load(std::memory_order_acquire);
+        item = current->get(t);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+};
+
+#endif //GRAPH_COLORING_WORKSTEALINGDEQUE_H